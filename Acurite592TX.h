@@ -145,7 +145,7 @@ public:
           case OK:       //in preamble
             flip++;
             if (SYNC-PULSE_TOL<width && width<SYNC+PULSE_TOL) {
-            } else if (flip>6) {  //could have missed preamble pulses, so check if this is data
+            } else if (flip>6 && level) {  //could have missed preamble pulses, so check if this is data
               state = T0;
               flip = 9;
               datapulses++;
@@ -171,18 +171,18 @@ public:
           case T0:  //data started
             flip++;
             datapulses++;
-            if (receivingBit == 0 && BIT0_LOW-PULSE_TOL<width && width<BIT0_LOW+PULSE_TOL) {
+            if (!level && receivingBit == 0 && BIT0_LOW-PULSE_TOL<width && width<BIT0_LOW+PULSE_TOL) {
               //0 bit low pulse. Bit received.
               gotBit(0);
               receivingBit=2;
-            } else if (receivingBit == 1 && BIT1_LOW-PULSE_TOL<width && width<BIT1_LOW+PULSE_TOL) {
+            } else if (!level && receivingBit == 1 && BIT1_LOW-PULSE_TOL<width && width<BIT1_LOW+PULSE_TOL) {
               //1 bit low pulse. Bit received.
               gotBit(1);
               receivingBit=2;
-            } else if (receivingBit == 2 && BIT1_HIGH-PULSE_TOL<width && width<BIT1_HIGH+PULSE_TOL) {
+            } else if (level && receivingBit == 2 && BIT1_HIGH-PULSE_TOL<width && width<BIT1_HIGH+PULSE_TOL) {
               //1 bit high pulse
               receivingBit=1;
-            } else if (receivingBit == 2 && BIT0_HIGH-PULSE_TOL<width && width<BIT0_HIGH+PULSE_TOL) {
+            } else if (level && receivingBit == 2 && BIT0_HIGH-PULSE_TOL<width && width<BIT0_HIGH+PULSE_TOL) {
               //0 bit high pulse
               receivingBit=0;
             } else {
@@ -200,8 +200,10 @@ public:
         return 0;
     }
     
-    bool nextPulse (word width) {
-        if (state != DONE)
+    bool nextPulse (word width, byte high) {
+        if (state != DONE) {
+            if (!inPhase(high))
+                resetDecoder();
             switch (decode(width)) {
                 case -1: 
                   resetDecoder(); 
@@ -212,9 +214,22 @@ public:
                   reverseBits();
                   break;
             }
+        }
         return isDone();
     }
     
+    // the low half of the last bit runs into the silence after the
+    // transmission, its high half already told us what the bit is
+    bool nextGap (void) {
+        if (state == T0 && datapulses == MAXBITS-1 && receivingBit != 2) {
+          gotBit(receivingBit);
+          done();
+          reverseBits();
+          return true;
+        }
+        return DecodeOOK::nextGap();
+    }
+    
     void resetDecoder (void) {
         i = datapulses = 0;
         receivingBit=2;
@@ -227,11 +242,12 @@ public:
 // Brad Hunting's Acurite_00592TX_sniffer project
 // https://github.com/bhunting/Acurite_00592TX_sniffer
     
-    void DecodePacket(void) {
-      char packet[100];
+    //returns false if the frame failed its checksum
+    bool DecodePacket(void) {
+      char packet[REPORT_SIZE];
+      bool ok;
       
-      noInterrupts();
-      if (checkData()) {
+      if ((ok = acceptFrame())) {
         //Serial.println("valid data");
 //        Serial.println("592");
         int channel = getChannel(data[0]);
@@ -250,14 +266,13 @@ public:
         
       
         Report(packet);
-        Serial.print("Acurite 592TX: ");
-        Serial.println(packet);
+        LOG_INFO(F("Acurite 592TX: "), packet);
         
         //digitalWrite(LED, LOW);
       } else {
         //Serial.println("invalid data");
       }
-      interrupts();
+      return ok;
     }
     
     int getTempF(byte hibyte, byte lobyte) {
@@ -267,8 +282,8 @@ public:
       int rawtemp = highbits | lowbits;
       
       //new decoded temperature
-      //return (int)((rawtemp-1000.)/10.);  //degC
-      return (int)((rawtemp-1000.)/10.*9./5.+32.);  //degF
+      //return (rawtemp-1000)/10;  //degC
+      return ((long)(rawtemp-1000)*9+1600)/50;  //degF, (rawtemp-1000)/10*9/5+32
       
       //Brian Hunting's decoded temperature
       //return (int)((rawtemp - 1024) / 10.0+2.4+0.5);  //degC
@@ -292,17 +307,13 @@ public:
       }
     }
     
-    int checkData(void) {
+    bool checkFrame(const byte* frame) {
       int sum = 0;
       for (int i = 0; i < 6; i++) {
-        sum += data[i];
-      }
-      sum -= data[6];
-      if (sum%256 == 0) {
-        return 1;
-      } else {
-        return 0;
+        sum += frame[i];
       }
+      sum -= frame[6];
+      return sum%256 == 0;
     }
     
     //Generate MQTT report and set temps to -99 so we don't report same data again
@@ -337,4 +348,4 @@ public:
         sprintf(packet,",TempC=%d,BatteryC=%d", tempC, batteryCok);
       }
     }
-};
+};
@@ -2,6 +2,9 @@
 * 
 */
 
+#include "fixed_point.h"
+#include "Aggregate.h"
+
 // pulse timings
 // SYNC
 #define SYNC_HI      725
@@ -27,10 +30,11 @@ protected:
     // wind directions:
     // { "NW", "WSW", "WNW", "W", "NNW", "SW", "N", "SSW",
     //   "ENE", "SE", "E", "ESE", "NE", "SSE", "NNE", "S" };
-    const float winddirections[16] = { 315.0, 247.5, 292.5, 270.0, 
-                                     337.5, 225.0, 0.0, 202.5,
-                                     67.5, 135.0, 90.0, 112.5,
-                                     45.0, 157.5, 22.5, 180.0 };
+    // in tenths of a degree
+    const uint16_t winddirections_x10[16] = { 3150, 2475, 2925, 2700,
+                                              3375, 2250,    0, 2025,
+                                               675, 1350,  900, 1125,
+                                               450, 1575,  225, 1800 };
 
     // message types
     #define  MT_WS_WD_RF  49    // wind speed, wind direction, rainfall
@@ -39,21 +43,28 @@ protected:
     byte datapulses=0;
     
     unsigned int   raincounter = 0;
-    float rainfall;
+    unsigned int rainfall_x100;       // inches
     unsigned int curraincounter;
-    float windspeedkph = -99;
-    float winddir;
-    float tempf;
+    int windspeed_x100 = -99;         // m/s
+    unsigned int winddir_x10;         // degrees
+    int tempf_x10;                    // degrees F
     int humidity;
     bool batteryok;
     
+    //summaries between reports
+    RunningStat<int> windstat_x100;   // m/s, the max is the peak gust
+    RunningStat<int> tempstat_x10;    // degrees F
+    int lastraincounter = -1;
+    BucketRing<12> rain1h_x100;       // inches, 5 minute buckets
+    BucketRing<24> rain24h_x100;      // inches, hourly buckets
+    
     //print related
     uint32_t g_PrintTime_ms = 0;
     uint32_t g_PrevPrintTime_ms = 0;
     uint32_t g_PrintTimeDelta_ms = 0;
           
 public:
-    Acurite5n1 () {}
+    Acurite5n1 () : rain1h_x100(300000UL), rain24h_x100(3600000UL) {}
     
     virtual char decode (word width) {
       if (SHORT_LO <= width && width <= SYNC_HI) {
@@ -73,7 +84,7 @@ public:
                     flip++;
                     if (SYNC_LO<width && width<SYNC_HI) {
                     }
-                    else if (flip>3) {  //could have missed preamble pulses, so check if this is data
+                    else if (flip>3 && level) {  //could have missed preamble pulses, so check if this is data
                       state = T0;
                       flip = 9;
                       datapulses++;
@@ -94,7 +105,7 @@ public:
                     
                 case T0:  //data started
                     flip++;
-                    if (flip%2 == 1) { //odd pulse is high
+                    if (level) { //bits are in the high pulses
                       datapulses++;
                       if (LONG_LO<width && width<LONG_HI) {
                         gotBit(1);
@@ -118,8 +129,10 @@ public:
         return 0;
     }
     
-    bool nextPulse (word width) {
-        if (state != DONE)
+    bool nextPulse (word width, byte high) {
+        if (state != DONE) {
+            if (!inPhase(high))
+                resetDecoder();
             switch (decode(width)) {
                 case -1: 
                   resetDecoder(); 
@@ -130,6 +143,7 @@ public:
                   reverseBits(); 
                   break;
             }
+        }
         return isDone();
     }
     
@@ -143,51 +157,70 @@ public:
 // Acurite 5n1 decode functions shamelessly stolen from Jens Jensen's project
 // https://github.com/zerog2k/acurite5n1arduino
 
-    void DecodePacket() {
-      char packet[100];
+    //returns false if the frame failed its checksum
+    bool DecodePacket() {
+      char packet[REPORT_SIZE];
+      bool ok;
       
-      noInterrupts();  //should interrupts be turned off for decoding?
-      if (acurite_crc(data, pos)) {
+      if ((ok = acceptFrame())) {
         // passes crc, good message
         digitalWrite(LED, HIGH);   
         
 //        Serial.println("5n1");  
 
-        windspeedkph = getWindSpeed(data[3], data[4]);
+        windspeed_x100 = getWindSpeed(data[3], data[4]);
+        windstat_x100.add(windspeed_x100);
         
         int msgtype = (data[2] & 0x3F);
         if (msgtype == MT_WS_WD_RF) {
           // wind speed, wind direction, rainfall
-          rainfall = 0.00;
+          rainfall_x100 = 0;
           curraincounter = getRainfallCounter(data[5], data[6]);
           
+          // a counter that went back was reset (new batteries), start
+          // counting from where it is now and add no rain for it
+          word tips = 0;
+          if (lastraincounter >= 0) {
+            if (curraincounter >= (unsigned int)lastraincounter)
+              tips = curraincounter - lastraincounter;
+            else
+              raincounter = curraincounter;
+            rain1h_x100.add(tips, clock->millis());
+            rain24h_x100.add(tips, clock->millis());
+          }
+          lastraincounter = curraincounter;
+          
           if (raincounter > 0) {
             // track rainfall difference after first run
-            rainfall = (curraincounter - raincounter) * 0.01;
+            rainfall_x100 = curraincounter - raincounter;
           } else {
             // capture starting counter
             raincounter = curraincounter; 
           }
           
-          winddir = getWindDirection(data[4]);
+          winddir_x10 = getWindDirection(data[4]);
           
         } else if (msgtype == MT_WS_T_RH) {
           // wind speed, temp, RH
-          tempf = getTempF(data[4], data[5]);
+          tempf_x10 = getTempF(data[4], data[5]);
+          tempstat_x10.add(tempf_x10);
           humidity = getHumidity(data[6]);
           batteryok = ((data[2] & 0x40) >> 6);
         }
         
         Report(packet);
-        Serial.print("Acurite 5n1: ");
-        Serial.println(packet);
+        LOG_INFO(F("Acurite 5n1: "), packet);
       }
       
       digitalWrite(LED, LOW);
-      interrupts();  //should interrupts be turned off for decoding?
+      return ok;
     }
     
-    bool acurite_crc(volatile byte row[], int cols) {
+    bool checkFrame (const byte* frame) {
+      return acurite_crc(frame, pos);
+    }
+
+    bool acurite_crc(const byte row[], int cols) {
     	// sum of first n-1 bytes modulo 256 should equal nth byte
     	cols -= 1; // last byte is CRC
         int sum = 0;
@@ -201,34 +234,32 @@ public:
     	}
     }
      
-    float getTempF(byte hibyte, byte lobyte) {
-      // range -40 to 158 F
+    int getTempF(byte hibyte, byte lobyte) {
+      // range -40 to 158 F, in tenths of a degree
       int highbits = (hibyte & 0x0F) << 7;
       int lowbits = lobyte & 0x7F;
       int rawtemp = highbits | lowbits;
-      float temp = (rawtemp - 400) / 10.0;
-      return temp;
+      return rawtemp - 400;
     }
 
-    float getWindSpeed(byte hibyte, byte lobyte) {
-      // range: 0 to 159 kph
+    int getWindSpeed(byte hibyte, byte lobyte) {
+      // range: 0 to 159 kph, in hundredths of a m/s
       int highbits = (hibyte & 0x7F) << 3;
       int lowbits = (lobyte & 0x7F) >> 4;
-      float speed = highbits | lowbits;
+      int speed = highbits | lowbits;
       // speed in m/s formula according to empirical data
       if (speed > 0) {
-        speed = speed * 0.23 + 0.28;
+        speed = speed * 23 + 28;
       }
-      float kph = speed * 60 * 60 / 1000;
-      return kph;
+      return speed;
     }
 
-    float getWindDirection(byte b) {
-      // 16 compass points, ccw from (NNW) to 15 (N), 
+    unsigned int getWindDirection(byte b) {
+      // 16 compass points, ccw from (NNW) to 15 (N), in tenths of a degree
             // { "NW", "WSW", "WNW", "W", "NNW", "SW", "N", "SSW",
             //   "ENE", "SE", "E", "ESE", "NE", "SSE", "NNE", "S" };
       int direction = b & 0x0F;
-      return winddirections[direction];
+      return winddirections_x10[direction];
     }
 
     int getHumidity(byte b) {
@@ -243,59 +274,94 @@ public:
       return raincounter;
     }
 
-    float convKphMph(float kph) {
-      return kph * 0.62137;
+    //Rain counter baseline and last value, to carry them over a reset.
+    //last is -1 before the first rain message.
+    void getRainCounters (unsigned int& base, int& last) {
+      base = raincounter;
+      last = lastraincounter;
     }
 
-    float convFC(float f) {
-      return (f-32) / 1.8;
-    }
-
-    float convInMm(float in) {
-      return in * 25.4;
+    void setRainCounters (unsigned int base, int last) {
+      raincounter = base;
+      lastraincounter = last;
     }
 
     //Generate MQTT report and set wind speed to -99 so we don't report same data again
     void MQTTreport (char* packet) {
-      float windspeed = convKphMph(windspeedkph);
-      char str_temp[10];
-      char str_winds[10];
-      char str_windd[10];
-      char str_rain[10];
+      char str_temp[FX_STR_SIZE];
+      char str_winds[FX_STR_SIZE];
+      char str_windd[FX_STR_SIZE];
+      char str_rain[FX_STR_SIZE];
       
       sprintf(packet,"");
       
-      if (windspeedkph != -99) {
-        dtostrf(tempf,5,1,str_temp);
-        dtostrf(windspeed,5,1,str_winds);
-        dtostrf(winddir,4,1,str_windd);
-        dtostrf(rainfall,5,2,str_rain);
+      if (windspeed_x100 != -99) {
+        fxtostrf(tempf_x10,5,1,str_temp,sizeof str_temp);
+        fxtostrf(convMsMph_x10(windspeed_x100),5,1,str_winds,sizeof str_winds);
+        fxtostrf(winddir_x10,4,1,str_windd,sizeof str_windd);
+        fxtostrf(rainfall_x100,5,2,str_rain,sizeof str_rain);
         
-        sprintf(packet,"Windspeed=%s,Winddir=%s,Rainfall=%s,TempF=%s,Humidity=%u,Battery=%u",
-          str_winds, str_windd, str_rain, str_temp, humidity, batteryok);
+        //A report that doesn't fit is dropped, not sent cut short
+        if (snprintf(packet,REPORT_SIZE,"Windspeed=%s,Winddir=%s,Rainfall=%s,TempF=%s,Humidity=%u,Battery=%u",
+            str_winds, str_windd, str_rain, str_temp, humidity, batteryok) >= REPORT_SIZE)
+          packet[0] = 0;
         
-        windspeedkph = -99;
+        windspeed_x100 = -99;
+      }
+    }
+
+    //Generate summary of the readings since the last one, then start over
+    void MQTTsummary (char* packet) {
+      char str_avg[FX_STR_SIZE];
+      char str_gust[FX_STR_SIZE];
+      char str_min[FX_STR_SIZE];
+      char str_max[FX_STR_SIZE];
+      char str_1h[FX_STR_SIZE];
+      char str_24h[FX_STR_SIZE];
+      
+      packet[0] = 0;
+      
+      if (windstat_x100.count() > 0) {
+        fxtostrf(convMsMph_x10(windstat_x100.mean()),1,1,str_avg,sizeof str_avg);
+        fxtostrf(convMsMph_x10(windstat_x100.max()),1,1,str_gust,sizeof str_gust);
+        fxtostrf(rain1h_x100.total(clock->millis()),1,2,str_1h,sizeof str_1h);
+        fxtostrf(rain24h_x100.total(clock->millis()),1,2,str_24h,sizeof str_24h);
+        if (snprintf(packet,REPORT_SIZE,"WindAvg=%s,Gust=%s,Rain1h=%s,Rain24h=%s",
+            str_avg, str_gust, str_1h, str_24h) >= REPORT_SIZE)
+          packet[0] = 0;
+        windstat_x100.clear();
+      }
+      if (tempstat_x10.count() > 0) {
+        fxtostrf(tempstat_x10.min(),1,1,str_min,sizeof str_min);
+        fxtostrf(tempstat_x10.max(),1,1,str_max,sizeof str_max);
+        fxtostrf(tempstat_x10.mean(),1,1,str_avg,sizeof str_avg);
+        size_t len = strlen(packet);
+        if (snprintf(packet + len,REPORT_SIZE - len,"%sTempMin=%s,TempMax=%s,TempAvg=%s",
+            len ? "," : "", str_min, str_max, str_avg) >= (int)(REPORT_SIZE - len))
+          packet[0] = 0;
+        tempstat_x10.clear();
       }
     }
 
     //Generate internal debugging report
     void Report (char* packet) {
-      float windspeed = convKphMph(windspeedkph);
-      char str_temp[10];
-      char str_winds[10];
-      char str_windd[10];
-      char str_rain[10];
+      char str_temp[FX_STR_SIZE];
+      char str_winds[FX_STR_SIZE];
+      char str_windd[FX_STR_SIZE];
+      char str_rain[FX_STR_SIZE];
       
       sprintf(packet,"");
       
-      if (windspeedkph != -99) {
-        dtostrf(tempf,5,1,str_temp);
-        dtostrf(windspeed,5,1,str_winds);
-        dtostrf(winddir,4,1,str_windd);
-        dtostrf(rainfall,5,2,str_rain);
+      if (windspeed_x100 != -99) {
+        fxtostrf(tempf_x10,5,1,str_temp,sizeof str_temp);
+        fxtostrf(convMsMph_x10(windspeed_x100),5,1,str_winds,sizeof str_winds);
+        fxtostrf(winddir_x10,4,1,str_windd,sizeof str_windd);
+        fxtostrf(rainfall_x100,5,2,str_rain,sizeof str_rain);
         
-        sprintf(packet,"Windspeed=%s,Winddir=%s,Rainfall=%s,TempF=%s,Humidity=%u,Battery=%u",
-          str_winds, str_windd, str_rain, str_temp, humidity, batteryok);
+        //A report that doesn't fit is dropped, not sent cut short
+        if (snprintf(packet,REPORT_SIZE,"Windspeed=%s,Winddir=%s,Rainfall=%s,TempF=%s,Humidity=%u,Battery=%u",
+            str_winds, str_windd, str_rain, str_temp, humidity, batteryok) >= REPORT_SIZE)
+          packet[0] = 0;
       }
     }
-};
+};
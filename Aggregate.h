@@ -0,0 +1,93 @@
+/*
+* Constant-memory summaries of sensor readings
+*
+* Readings come in every few seconds but are only reported every
+* REPORT_TIME, so everything in between used to be thrown away.  RunningStat
+* keeps the minimum, maximum and mean of a quantity over one report interval,
+* BucketRing keeps a rolling total (rain over the last hour or day) in a fixed
+* number of time buckets.  Neither stores the readings themselves.
+*/
+
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include "fixed_point.h"
+
+// min, max and mean of the readings since the last clear()
+template <typename T>
+class RunningStat {
+protected:
+    long sum;
+    T lo, hi;
+    word n;
+
+public:
+    RunningStat () { clear(); }
+
+    void clear (void) {
+        sum = 0;
+        n = 0;
+    }
+
+    void add (T value) {
+        if (n == 0 || value < lo)
+            lo = value;
+        if (n == 0 || value > hi)
+            hi = value;
+        sum += value;
+        if (++n == 0xFFFF)  // keep the mean right rather than wrap
+            clear();
+    }
+
+    word count () const { return n; }
+    T min () const { return lo; }
+    T max () const { return hi; }
+    T mean () const { return n ? (T)fxdiv(sum, n) : 0; }
+};
+
+// rolling total over N buckets of spanMs each.  The total covers between
+// N-1 and N bucket spans, the oldest bucket drops out as a new one starts.
+template <byte N>
+class BucketRing {
+protected:
+    word bucket[N];
+    byte head;
+    uint32_t start;       // clock millis() the head bucket started
+    unsigned long span;
+
+    void advance (unsigned long now) {
+        if ((uint32_t)(now - start) >= span * N) {
+            // silent for longer than the whole ring, nothing is left of it
+            for (byte i = 0; i < N; ++i)
+                bucket[i] = 0;
+            start = now;
+            return;
+        }
+        while ((uint32_t)(now - start) >= span) {
+            start += span;
+            head = (head + 1) % N;
+            bucket[head] = 0;
+        }
+    }
+
+public:
+    BucketRing (unsigned long spanMs) : head(0), start(0), span(spanMs) {
+        for (byte i = 0; i < N; ++i)
+            bucket[i] = 0;
+    }
+
+    void add (word amount, unsigned long now) {
+        advance(now);
+        bucket[head] += amount;
+    }
+
+    unsigned long total (unsigned long now) {
+        advance(now);
+        unsigned long sum = 0;
+        for (byte i = 0; i < N; ++i)
+            sum += bucket[i];
+        return sum;
+    }
+};
+
+#endif
@@ -56,32 +56,82 @@
 
 //#include "stdint.h"
 #include "temp_lerp.h"
+#include "Aggregate.h"
 
 #define OOK_PACKET_INSTANT 1
 #define OOK_PACKET_TEMP    2
 #define OOK_PACKET_TOTAL   3
 
+//g_RxWatts when there's been no power reading since the last report
+#define NO_WATTS 0xFFFF
+
 //Transmitter ID set on Blueline meter
 #define DEFAULT_TX_ID 0x16E0
 
-//Kh value of meter.  Typically 1 for digital and 7.2 for analog.
-//Calculated 29.2
-//Meter indicates 40
-#define Kh 1.0
+//Kh value of meter in tenths.  Typically 10 for digital and 72 for analog.
+//Calculated 292
+//Meter indicates 400
+#define Kh_x10 10
+
+//Bit position (MSB of the first byte is 0) of the single bit error that
+//leaves this CRC-8-ATM remainder over a 3 byte frame, 0xFF if no single bit
+//error does.  The CRC is linear so the remainder of a frame with one flipped
+//bit is the remainder of that bit alone, and all 24 of those are distinct.
+#define NO_SYNDROME 0xFF
+const uint8_t crc8_syndrome[256] PROGMEM = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x17, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0x16, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x15, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x14, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x04, 0xFF, 0xFF, 0x0D, 0xFF, 0xFF, 0x0B, 0xFF, 0xFF, 0xFF, 0x09, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x13, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0x10, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0C, 0xFF, 0xFF, 0x05, 0xFF, 0xFF, 0x0A, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x11, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x06, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x12, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
 
+//The demodulated low pulses (gaps) go through a sliding window, newest bit
+//lowest: a short gap is 1, a long one 0, the >1250us gap that ends the
+//preamble is a sync.  The 0xfe preamble comes out as three short gaps and
+//the sync, so a frame is the window holding 111, sync, 24 data bits.
+//Gaps that fit none of those, or follow a bad high pulse, are marks that
+//spoil any frame they'd be in.
+#define BL_SYNC_AT    24          //sync position when a frame is complete
+#define BL_PREAMBLE   0x07UL      //short gaps before the sync
+#define BL_FRAME_MASK 0x01FFFFFFUL
+#define BL_SYNC_BIT   (1UL << BL_SYNC_AT)
+#define BL_TEMP_STEP  2           //raw steps (under 2F) a lone repaired temperature may move
 
 class Blueline : public DecodeOOK {
 protected:
-    byte i;
-    bool g_battStatus;
-    uint8_t g_RxTemperature;
+    bool g_battStatus = false;
+    uint8_t g_RxTemperature = 0;
     uint8_t g_RxFlags;
-    uint16_t g_RxWatts = -99;
-    uint16_t g_RxWattHours;
-    uint16_t g_TxId = DEFAULT_TX_ID;  //This should work, but if the object gets reset for some reason it will potentially break 
+    uint16_t g_RxWatts = NO_WATTS;
+    bool g_HaveTemp = false;
+    uint16_t g_LastTemp;               //last raw temperature frame value
+    uint16_t g_RxWattHours = 0;
+    RunningStat<uint16_t> g_WattStat;  //power between reports
+    bool g_HaveEnergy = false;
+    uint16_t g_PrevEnergy;             //last raw energy count
+    uint32_t g_Energy_x2500 = 0;       //Wh * 2500 used since the last report
+    uint16_t g_TxId = DEFAULT_TX_ID;  //until an ID frame comes in or setTxId() restores a learned one
     bool g_RxDirty;
     uint32_t g_RxLast;
-    uint8_t packetTime;
+    word g_Corrected;
+    bool g_HaveLastFrame = false;
+    byte g_LastFrame[3];               //last frame that passed its CRC
+    uint32_t g_LastFrameTime;          //ms
+    uint32_t window;   //gap bits, newest lowest
+    uint32_t marks;    //syncs and bad gaps at the same positions
+    bool spoilt;       //the high before the next gap was out of range
     
     //print related
     uint32_t g_PrintTime_ms = 0;
@@ -89,69 +139,104 @@ protected:
     uint32_t g_PrintTimeDelta_ms = 0;
     
 public:
-    Blueline () {}
-    
-    String debug;
+    Blueline () : g_Corrected(0), window(0), marks(0), spoilt(false) {}
     
+    //shift one pulse into the window, 1 once it holds a whole frame.  A
+    //frame with its preamble intact is taken as it is, its CRC is checked
+    //(and maybe corrected or voted on) by decodeRxPacket.  Where the
+    //preamble is damaged the sync and a valid CRC have to do.
     virtual char decode (word width) {
-      debug = String(String(++i,DEC) + "/" + String(width,DEC));
-      
-      if (375 <= width && width <= 1625) {
-          switch (state) {
-                case UNKNOWN:  //no data yet
-                    if (width<750) {
-                        //valid start pulse is short high
-                        flip++;
-                        state = OK;
-                        packetTime = millis();
-                    }
-                    else {
-                      return -1;
-                    }
-                    break;
-                case OK:       //in preamble
-                    if (width < 750) {
-                        flip++;
-                    }
-                    else if (++flip >= 8 && width > 1250) {
-                        //preamble is 7 short + 1 extra long low pulses
-                        state = T0;  //preamble done
-                        flip=16;  //flip should be 14 when 1500us pulse is seen
-                    }
-                    else {
-                        return -1;  //preamble failed
-                    }
-                    break;
-                case T0:  //data started
-                    flip++;
-                    if (flip%2 == 0) { //even pulse is low
-                      gotBit(width < 750);
-                    }
-                    else
-                    break;
-            }
-        } else {
-          return -1;  //pulse length out of range
-        }
-        
-        if (flip == 64) {
-          return 1;
-        }
+      if (level) {
+        //highs only carry timing
+        spoilt = spoilt || width < 375 || width >= 750;
+        return 0;
+      }
+
+      byte bit = 1, mark = 0;
+      if (spoilt || width < 375 || width > 1625) {
+        mark = 1;               //bad gap, bit 1 so it can't pass for a sync
+      } else if (width > 1250) {
+        bit = 0;                //sync
+        mark = 1;
+      } else if (width >= 750) {
+        bit = 0;
+      }
+      spoilt = false;
+      window = window << 1 | bit;
+      marks = marks << 1 | mark;
+
+      if ((marks & BL_FRAME_MASK) != BL_SYNC_BIT || (window & BL_SYNC_BIT))
         return 0;
+      data[0] = window >> 16;
+      data[1] = window >> 8;
+      data[2] = window;
+      bool preamble = (window >> (BL_SYNC_AT + 1) & BL_PREAMBLE) == BL_PREAMBLE &&
+        !(marks >> (BL_SYNC_AT + 1) & BL_PREAMBLE);
+      return preamble || checkFrame(data) ? 1 : 0;
     }
     
-    bool nextPulse (word width) {
-        if (state != DONE)
-            switch (decode(width)) {
-                case -1: resetDecoder(); break;
-                case 1:  done(); reverseBits(); break;
+    //hides DecodeOOK::nextPulse(), the window needs no phase check or reset
+    bool nextPulse (word width, byte high) {
+        if (state != DONE) {
+            state = OK;
+            level = high;
+            if (decode(width) == 1) {
+              pos = 3;
+              state = DONE;
             }
+        }
         return isDone();
     }
     
+    //the automaton saw the preamble, the sync gap is the next pulse.  Hides
+    //DecodeOOK::prime(), the preamble always goes in as its three short gaps.
+    void prime (byte /*count*/, byte high) {
+        resetDecoder();
+        state = OK;
+        level = !high;
+        window = BL_PREAMBLE;
+    }
+    
+    //a frame was taken, carry on with the same window so the next frame of
+    //the packet follows without being primed again.  Not after a gap, the
+    //window then holds nothing the next packet can use.
+    void rearm (void) {
+        pos = 0;
+        state = OK;
+    }
+    
+    // the low half of the last CRC bit runs into the silence after the
+    // packet, so its length is lost.  Try it as a long (0) bit, then as a
+    // short (1) one, and take whichever passes the CRC as it is.
+    bool nextGap (void) {
+        if (state == OK) {
+          level = 0;
+          if (lastBit(1000) || lastBit(500)) {
+            pos = 3;
+            state = DONE;
+            return true;
+          }
+        }
+        return DecodeOOK::nextGap();
+    }
+    
+    //true if the last gap as width completes a frame with a valid CRC,
+    //otherwise the window is left as it was
+    bool lastBit (word width) {
+        uint32_t w = window, m = marks;
+        bool s = spoilt;
+        if (decode(width) == 1 && checkFrame(data))
+          return true;
+        window = w;
+        marks = m;
+        spoilt = s;
+        return false;
+    }
+    
     void resetDecoder (void) {
-        i = 0;
         g_RxDirty = false;
+        window = marks = 0;
+        spoilt = false;
         DecodeOOK::resetDecoder();
     }
     
@@ -160,8 +245,17 @@ public:
       return g_RxDirty;
     }
 
+    //Transmitter ID learned from the last ID frame
+    uint16_t txId (void) {
+      return g_TxId;
+    }
+
+    void setTxId (uint16_t id) {
+      g_TxId = id;
+    }
+
     //Time last packet bit 1 was seen    
-    uint8_t RxLast (void) {
+    uint32_t RxLast (void) {
       return g_RxLast;
     }
 
@@ -171,12 +265,26 @@ public:
       
       sprintf(packet,"");
       
-      if (g_RxWatts != -99) {
+      if (g_RxWatts != NO_WATTS) {
         if (g_battStatus) batt=1;
         sprintf(packet, "TotalEnergy=%u,CurrentPower=%u,TempF=%u,Battery=%u",
           g_RxWattHours, g_RxWatts, g_RxTemperature, batt);
         
-        g_RxWatts = -99;
+        g_RxWatts = NO_WATTS;
+      }
+    }
+
+    //Generate summary of the readings since the last one, then start over.
+    //Energy is what was used in between, whole Wh only, the rest carries over.
+    void MQTTsummary (char* packet) {
+      packet[0] = 0;
+      
+      if (g_WattStat.count() > 0) {
+        uint32_t wh = g_Energy_x2500 / 2500;
+        g_Energy_x2500 -= wh * 2500;
+        sprintf(packet, "PowerMin=%u,PowerMax=%u,PowerAvg=%u,Energy=%lu",
+          g_WattStat.min(), g_WattStat.max(), g_WattStat.mean(), (unsigned long)wh);
+        g_WattStat.clear();
       }
     }
 
@@ -186,7 +294,7 @@ public:
       
       sprintf(packet,"");
       
-      if (g_RxWatts != -99) {
+      if (g_RxWatts != NO_WATTS) {
         if (g_battStatus) batt=1;
         sprintf(packet, "TotalEnergy=%u,CurrentPower=%u,TempF=%u,Battery=%u",
           g_RxWattHours, g_RxWatts, g_RxTemperature, batt);
@@ -214,36 +322,49 @@ public:
       return crc >> 8;
     }
     
+    //val16 is the frame value with the transmitter ID offset taken off
     void decodePowermon(uint16_t val16)
     {
-      char packet[100];
+      char packet[REPORT_SIZE];
 
 //      Serial.println("blueline");
-      switch (data[0] & 3)
+      switch (val16 & 3)
       {
       case OOK_PACKET_INSTANT:
         // val16 is the number of milliseconds between blinks
         // Each blink is one watt hour consumed
-        g_RxWatts = 3600000UL / val16 * Kh;
+        // a count of 0 can pass the CRC but isn't a reading
+        if ((val16 & 0xfffc) == 0)
+          return;
+        g_RxWatts = 3600000UL / (val16 & 0xfffc) * Kh_x10 / 10;
+        g_WattStat.add(g_RxWatts);
         break;
     
       case OOK_PACKET_TEMP:
-        g_RxTemperature = temp_lerp(data[1]);
-        g_RxFlags = data[0];
+        g_RxTemperature = temp_lerp(val16 >> 8);
+        g_RxFlags = val16 & 0xff;
         g_battStatus = BatteryStatus(g_RxFlags);
+        g_LastTemp = val16;
+        g_HaveTemp = true;
         break;
     
       case OOK_PACKET_TOTAL:
         //g_PrevRxWattHours = g_RxWattHours;
-        g_RxWattHours = 0.004 * val16 * Kh;
+        // 0.004 * val16 * Kh
+        g_RxWattHours = (uint32_t)(val16 & 0xfffc) * Kh_x10 / 2500;
+        // the raw count wraps at 16 bits (g_RxWattHours long before that),
+        // unsigned subtraction of the raw counts gets the delta right anyway
+        if (g_HaveEnergy)
+          g_Energy_x2500 += (uint32_t)(uint16_t)((val16 & 0xfffc) - g_PrevEnergy) * Kh_x10;
+        g_PrevEnergy = val16 & 0xfffc;
+        g_HaveEnergy = true;
         // prevent rollover through the power of unsigned arithmetic
         //g_TotalRxWattHours += (g_RxWattHours - g_PrevRxWattHours);
         break;
       }
       
       Report(packet);
-      Serial.print("Blueline: ");
-      Serial.println(packet);
+      LOG_INFO(F("Blueline: "), packet);
     }
     
     bool BatteryStatus(uint8_t data) {
@@ -252,25 +373,111 @@ public:
       return battBit==0;
     }
     
-    void decodeRxPacket(void)
+    //an ID frame has its CRC over the raw bytes, a data frame over the
+    //bytes with the transmitter ID taken off
+    bool checkFrame(const byte* frame)
     {
-      uint16_t val16 = *(uint16_t *)data;
-      if (crc8(data, 3) == 0)
-      {
-        g_TxId = data[1] << 8 | data[0];
-        Serial.print(F("NEW DEVICE id="));
-        Serial.println(val16, HEX);
-        return;
+      if (crc8(frame, 3) == 0)
+        return true;
+      uint16_t val16 = (frame[1] << 8 | frame[0]) - g_TxId;
+      byte offset[3] = { (byte)(val16 & 0xff), (byte)(val16 >> 8), frame[2] };
+      return crc8(offset, 3) == 0;
+    }
+    
+    //A data frame with one bit flipped on the air is located with the
+    //syndrome of its offset CRC.  Taking off the ID is a subtraction, so a
+    //flipped bit can borrow into others and the syndrome then points at the
+    //wrong bit.  The correction is only taken when the repaired frame differs
+    //from the received one in a single bit, doesn't read as an ID frame, and
+    //no other single data bit flip passes the CRC too.  ID frames themselves
+    //are never corrected, a wrong one would change g_TxId.
+    //
+    //Even then about 6% of random frames get repaired into ones that pass,
+    //so the repair also needs something to back it up.  Either a failed
+    //copy kept for voting is one bit off it, or it is a temperature that
+    //carries on from the last one (see follows()).  A repair that is the
+    //last frame that passed is a damaged repeat: it's taken like an intact
+    //one but not counted, it recovers nothing.
+    //
+    //So a single bit error in a lone power or energy frame, one with no
+    //other copy to back it up, is thrown away rather than corrected: those
+    //readings are never close enough to the last ones to tell a repair
+    //from noise.  The packet's other copies or the next packet carry them.
+    bool correctFrame(byte* frame)
+    {
+      uint16_t val16 = (frame[1] << 8 | frame[0]) - g_TxId;
+      byte offset[3] = { (byte)(val16 & 0xff), (byte)(val16 >> 8), frame[2] };
+      byte bit = pgm_read_byte(&crc8_syndrome[crc8(offset, 3)]);
+      if (bit == NO_SYNDROME)
+        return false;
+
+      offset[bit >> 3] ^= 0x80 >> (bit & 7);
+      val16 = (offset[1] << 8 | offset[0]) + g_TxId;
+      byte fixed[3] = { (byte)(val16 & 0xff), (byte)(val16 >> 8), offset[2] };
+      byte flipped = 0;
+      for (byte j = 0; j < 3; ++j)
+        for (byte diff = fixed[j] ^ frame[j]; diff; diff &= diff - 1)
+          ++flipped;
+      if (flipped != 1 || crc8(fixed, 3) == 0 || !checkFrame(fixed))
+        return false;
+
+      //CRC byte flips don't go through the offset, the syndrome alone
+      //rules those out as rivals
+      for (byte k = 0; k < 16; ++k) {
+        byte other[3] = { frame[0], frame[1], frame[2] };
+        other[k >> 3] ^= 0x80 >> (k & 7);
+        if (memcmp(other, fixed, 3) != 0 && checkFrame(other))
+          return false;
       }
+
+      uint32_t now = clock->millis();
+      bool repeat = g_HaveLastFrame && now - g_LastFrameTime <= VOTE_WINDOW &&
+        memcmp(g_LastFrame, fixed, 3) == 0;
+      if (!repeat && !vote.near(fixed, 3, now) && !follows(offset[1] << 8 | offset[0]))
+        return false;
+
+      memcpy(frame, fixed, 3);
+      if (!repeat)
+        g_Corrected++;
+      return true;
+    }
+
+    //true if a repaired data value is a temperature noise would hardly
+    //ever make: the flags of the last one and within BL_TEMP_STEP of it.
+    //Power and energy move too far between frames to be checked this way,
+    //the 16 bit energy count wraps every few hundred Wh.
+    bool follows(uint16_t val16)
+    {
+      return (val16 & 3) == OOK_PACKET_TEMP && g_HaveTemp &&
+        (val16 & 0xff) == (g_LastTemp & 0xff) &&
+        abs((int)(val16 >> 8) - (int)(g_LastTemp >> 8)) <= BL_TEMP_STEP;
+    }
+
+    //frames that passed their CRC only after a single bit correction
+    word corrected (void) {
+      return g_Corrected;
+    }
     
-      val16 -= g_TxId;
-      data[0] = val16 & 0xff;
-      data[1] = val16 >> 8;
+    //returns false if the frame failed its CRC, data is left as received
+    bool decodeRxPacket(void)
+    {
+      if (!acceptFrame())
+        return false;
+      memcpy(g_LastFrame, data, 3);
+      g_LastFrameTime = clock->millis();
+      g_HaveLastFrame = true;
+
+      uint16_t val16 = data[1] << 8 | data[0];
       if (crc8(data, 3) == 0)
       {
-        decodePowermon(val16 & 0xfffc);
-        g_RxDirty = true;
-        g_RxLast = millis();
+        g_TxId = val16;
+        LOG_INFO(F("NEW DEVICE id="), logHex(val16));
+        return true;
       }
+    
+      decodePowermon(val16 - g_TxId);
+      g_RxDirty = true;
+      g_RxLast = clock->millis();
+      return true;
     }
-};
+};
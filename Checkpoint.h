@@ -0,0 +1,103 @@
+/*
+* Wear-leveled state log in EEPROM
+*
+* Learned state (transmitter IDs, rain counter baselines) is lost on every
+* reset.  Checkpoint keeps it in a ring of CHECKPOINT_SLOTS records of the
+* form sequence, state, check byte.  Every save() goes to the slot after the
+* newest one, so each EEPROM cell is only written once per CHECKPOINT_SLOTS
+* saves, and a save is skipped altogether when the state hasn't changed.
+*
+* restore() takes the newest valid record: the one whose successor isn't its
+* sequence + 1.  A record torn by a reset mid-write fails its check byte
+* (written last) and the one before it is used instead.
+*
+* The Acurite timings are fixed #defines, so there is no calibrated timing to
+* keep yet.  The state size goes into the check byte, so when the state struct
+* grows the old records stop checking and the log starts over.
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <EEPROM.h>
+
+#define CHECKPOINT_BASE   0     // first EEPROM address used
+#define CHECKPOINT_SLOTS  64    // records in the ring
+#define CHECKPOINT_SEED   0xA5  // so erased (0xFF) or zeroed slots don't check
+
+template <typename T>
+class Checkpoint {
+protected:
+    enum { RECORD = sizeof(T) + 2 };  // sequence, state, check byte
+
+    byte head;       // slot of the newest record
+    byte seq;        // its sequence number
+    bool found;      // false until there's a record to follow
+    T last;          // state in the newest record
+
+    int address (byte slot) {
+        return CHECKPOINT_BASE + slot * RECORD;
+    }
+
+    // true and the record's sequence number if the slot holds a whole record
+    bool valid (byte slot, byte& sequence) {
+        int addr = address(slot);
+        byte sum = CHECKPOINT_SEED + sizeof(T);
+        for (byte i = 0; i < RECORD - 1; ++i)
+            sum += EEPROM.read(addr + i);
+        sequence = EEPROM.read(addr);
+        return sum == EEPROM.read(addr + RECORD - 1);
+    }
+
+public:
+    Checkpoint () : head(CHECKPOINT_SLOTS - 1), seq(0), found(false) {}
+
+    // false if there is no valid record, e.g. on a new board
+    bool restore (T& state) {
+        for (byte slot = 0; slot < CHECKPOINT_SLOTS; ++slot) {
+            byte s, n;
+            if (!valid(slot, s))
+                continue;
+            byte next = (slot + 1) % CHECKPOINT_SLOTS;
+            if (valid(next, n) && n == (byte)(s + 1))
+                continue;
+            head = slot;
+            seq = s;
+            found = true;
+            break;
+        }
+        if (!found)
+            return false;
+
+        int addr = address(head) + 1;
+        byte* p = (byte*)&last;
+        for (byte i = 0; i < sizeof(T); ++i)
+            p[i] = EEPROM.read(addr + i);
+        state = last;
+        return true;
+    }
+
+    // append state as the newest record unless it's what's stored already
+    void save (const T& state) {
+        if (found && memcmp(&state, &last, sizeof(T)) == 0)
+            return;
+
+        head = (head + 1) % CHECKPOINT_SLOTS;
+        seq++;
+        int addr = address(head);
+        const byte* p = (const byte*)&state;
+        byte sum = CHECKPOINT_SEED + sizeof(T) + seq;
+
+        EEPROM.write(addr, seq);
+        for (byte i = 0; i < sizeof(T); ++i) {
+            EEPROM.write(addr + 1 + i, p[i]);
+            sum += p[i];
+        }
+        EEPROM.write(addr + RECORD - 1, sum);
+
+        last = state;
+        found = true;
+    }
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*
+* Time source for everything that isn't pulse timing
+*
+* Decoders, aggregators and report scheduling ask a Clock for the time
+* instead of calling millis() directly.  On the board that's SystemClock.
+* A host replay uses a VirtualClock that follows the timestamps of the pulses
+* it is fed, so a day of recorded traffic, report intervals included, runs in
+* seconds and gives the same result every time.
+*
+* Pulse timestamps themselves come from the PulseSource, the interrupt
+* sources keep using micros() since they stamp real edges.
+*
+* Times are 32 bits as on the AVR, micros() wraps after 71 minutes and
+* millis() after 49.7 days.  Longs are 64 bits on a host, so a difference
+* of two times is taken as a uint32_t to wrap the same way there.
+*/
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+class Clock {
+public:
+    virtual ~Clock () {}
+
+    virtual unsigned long millis (void) =0;
+    virtual unsigned long micros (void) =0;
+
+    // the receiver saw a pulse ending at us (micros() of its source)
+    virtual void tick (unsigned long /*us*/) {}
+};
+
+class SystemClock : public Clock {
+public:
+    virtual unsigned long millis (void) { return ::millis(); }
+    virtual unsigned long micros (void) { return ::micros(); }
+};
+
+// time as far as the replayed pulses have got, starting at startMs
+// millis() so a replay can be run across a rollover.  The pulse timestamps
+// given to tick() start at startMs * 1000 us as well.
+class VirtualClock : public Clock {
+protected:
+    uint32_t us;         // micros()
+    uint32_t ms;         // millis(), counted on its own so it wraps at 2^32 ms too
+    uint16_t partial;    // us towards the next ms
+    unsigned long last;  // pulse timestamp of the last tick()
+
+public:
+    VirtualClock (unsigned long startMs =0)
+        : us(startMs * 1000), ms(startMs), partial(0), last(startMs * 1000) {}
+
+    virtual unsigned long millis (void) { return ms; }
+    virtual unsigned long micros (void) { return us; }
+    virtual void tick (unsigned long stamp) {
+        advance(stamp - last);
+        last = stamp;
+    }
+
+    void advance (unsigned long dus) {
+        us += dus;
+        unsigned long total = partial + dus;
+        ms += total / 1000;
+        partial = total % 1000;
+    }
+};
+
+static SystemClock systemClock;
+
+// fires once every interval ms of clock time
+class ReportTimer {
+protected:
+    Clock* clock;
+    unsigned long last;
+    unsigned long interval;
+
+public:
+    ReportTimer (Clock* c, unsigned long intervalMs)
+        : clock(c), last(c->millis()), interval(intervalMs) {}
+
+    bool due (void) {
+        unsigned long now = clock->millis();
+        if ((uint32_t)(now - last) <= interval)
+            return false;
+        last = now;
+        return true;
+    }
+};
+
+#endif
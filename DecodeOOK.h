@@ -1,8 +1,16 @@
 #include <Arduino.h>
+#include "FrameVote.h"
+#include "Clock.h"
+#include "Log.h"
+
+#define REPORT_SIZE  100  // bytes of the packet buffers reports are written into
 
 class DecodeOOK {
 protected:
     byte total_bits, bits, flip, state, pos, data[25];
+    byte level;  // line level of the pulse being decoded, 1 = carrier on
+    FrameVote vote;  // recent copies that failed checkFrame()
+    Clock* clock;
     
     virtual char decode (word width) =0;
 
@@ -10,25 +18,101 @@ public:
 
     enum { UNKNOWN, T0, T1, T2, T3, OK, DONE };
 
-    DecodeOOK () { resetDecoder(); }
+    DecodeOOK () : clock(&systemClock) { resetDecoder(); }
 
-    bool nextPulse (word width) {
-        if (state != DONE)
+    void setClock (Clock* c) { clock = c; }
+
+    // nextPulse() and prime() run on every pulse, so they aren't virtual.  A
+    // protocol may hide them with its own, OokReceiver::feed() is a template
+    // and calls them on the concrete decoder type.  Don't call them through
+    // a DecodeOOK pointer or reference, that gets these versions.
+    bool nextPulse (word width, byte high) {
+        if (state != DONE) {
+            if (!inPhase(high))
+                resetDecoder();
             switch (decode(width)) {
                 case -1: resetDecoder(); break;
                 case 1:  done(); break;
             }
+        }
+        return isDone();
+    }
+
+    // Levels alternate on the air, two pulses in a row with the same level
+    // mean an edge was lost and the rest of the frame is out of phase.
+    // The caller resets and retries the pulse as the start of a new frame.
+    bool inPhase (byte high) {
+        bool ok = state == UNKNOWN || high != level;
+        level = high;
+        return ok;
+    }
+
+    // called when the line has been silent long enough to end a frame,
+    // a partial frame can't be completed any more so drop it
+    virtual bool nextGap () {
+        if (state != DONE)
+            resetDecoder();
         return isDone();
     }
 
     bool isDone () const { return state == DONE; }
 
+    // inside a frame, past the preamble or part way through it
+    bool isActive () const { return state != UNKNOWN && state != DONE; }
+
+    // pick up after count preamble pulses recognized elsewhere as if they
+    // had been decoded here, the pulse that ended the preamble comes next
+    void prime (byte count, byte high) {
+        resetDecoder();
+        state = OK;
+        flip = count;
+        level = !high;
+    }
+
+    // checksum of a complete frame, the protocols override this
+    virtual bool checkFrame (const byte* /*frame*/) { return true; }
+
+    // repair a frame that failed checkFrame() in place if the protocol's
+    // checksum allows it, false if it can't be repaired
+    virtual bool correctFrame (byte* /*frame*/) { return false; }
+
+    // true if the frame in data passes its check, possibly after correction.
+    // A copy that fails is kept, and once enough failed copies are in their
+    // majority replaces data if it passes instead.
+    bool acceptFrame (void) {
+        if (checkFrame(data) || correctFrame(data)) {
+            vote.clear();
+            return true;
+        }
+        byte voted[VOTE_BYTES];
+        vote.add(data, pos, clock->millis());
+        if (!vote.vote(voted, pos, clock->millis()) || !checkFrame(voted))
+            return false;
+        memcpy(data, voted, pos);
+        vote.clear();
+        vote.recovered++;
+        return true;
+    }
+
+    // frames that only passed their check thanks to voting
+    word recovered () const { return vote.recovered; }
+
     const byte* getData (byte& count) const {
         count = pos;
         return data;
     }
 
-    void resetDecoder () {
+    // load a complete frame captured elsewhere, e.g. by another receiver
+    void setData (const byte* bytes, byte count) {
+        resetDecoder();
+        if (count > sizeof data)
+            count = sizeof data;
+        memcpy(data, bytes, count);
+        pos = count;
+        state = DONE;
+    }
+
+    virtual void resetDecoder () {
         total_bits = bits = pos = flip = 0;
         state = UNKNOWN;
         //Serial.println("DecodeOOK.resetDecoder");
@@ -97,7 +181,7 @@ public:
     }
 
     void PrintRaw (void) {
-      char packet[100];
+      char packet[REPORT_SIZE];
       
       sprintf(packet,"");
       for (byte i = 0; i < pos; ++i) {
@@ -106,4 +190,4 @@ public:
       sprintf(packet,"  ");
       Serial.print(packet);
     }
-};
+};
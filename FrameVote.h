@@ -0,0 +1,89 @@
+/*
+* Repeat-frame majority voting
+*
+* Most sensors send the same frame several times in one transmission window.
+* When a copy fails its checksum it is kept here instead of being dropped, and
+* once VOTE_COPIES failed copies of the same length have come in within
+* VOTE_WINDOW ms of each other every bit is decided by majority.  A bit error
+* in one copy is outvoted by the other two.  The copies have to be within
+* VOTE_BITS bits of each other, three unrelated noise frames voted on pass
+* the checksum as often as any one of them would.  The decoder still has to
+* check the voted frame, only a frame that passes is accepted.
+*/
+
+#ifndef FRAME_VOTE_H
+#define FRAME_VOTE_H
+
+#define VOTE_COPIES  3     // failed copies voted on, vote() takes the majority of three
+#define VOTE_BYTES   8     // longest frame that can be voted on
+#define VOTE_WINDOW  1000  // ms a failed copy stays eligible
+#define VOTE_BITS    2     // most bits any two copies voted on may differ in
+
+class FrameVote {
+protected:
+    byte copies[VOTE_COPIES][VOTE_BYTES];
+    byte len[VOTE_COPIES];
+    unsigned long seen[VOTE_COPIES];
+    byte next;
+
+    // bits a and b differ in, counting stops at limit
+    static byte differ (const byte* a, const byte* b, byte count, byte limit) {
+        byte flipped = 0;
+        for (byte j = 0; j < count && flipped < limit; ++j)
+            for (byte diff = a[j] ^ b[j]; diff && flipped < limit; diff &= diff - 1)
+                ++flipped;
+        return flipped;
+    }
+
+public:
+    word recovered;  // frames accepted only thanks to a vote
+
+    FrameVote () : next(0), recovered(0) { clear(); }
+
+    void clear (void) {
+        for (byte i = 0; i < VOTE_COPIES; ++i)
+            len[i] = 0;
+    }
+
+    // keep a copy that failed its check, the oldest one makes room
+    void add (const byte* data, byte count, unsigned long now) {
+        if (count > VOTE_BYTES)
+            return;
+        memcpy(copies[next], data, count);
+        len[next] = count;
+        seen[next] = now;
+        next = (next + 1) % VOTE_COPIES;
+    }
+
+    // true if a recent kept copy of this length differs from data in at
+    // most one bit, i.e. data could be that copy with its bit error fixed
+    bool near (const byte* data, byte count, unsigned long now) const {
+        for (byte i = 0; i < VOTE_COPIES; ++i) {
+            if (len[i] != count || (uint32_t)(now - seen[i]) > VOTE_WINDOW)
+                continue;
+            if (differ(copies[i], data, count, 2) < 2)
+                return true;
+        }
+        return false;
+    }
+
+    // write the bitwise majority of the kept copies to out, false if there
+    // aren't enough recent copies of this length close enough to vote
+    bool vote (byte* out, byte count, unsigned long now) {
+        for (byte i = 0; i < VOTE_COPIES; ++i)
+            if (len[i] != count || (uint32_t)(now - seen[i]) > VOTE_WINDOW)
+                return false;
+        for (byte i = 0; i < VOTE_COPIES; ++i)
+            for (byte k = i + 1; k < VOTE_COPIES; ++k)
+                if (differ(copies[i], copies[k], count, VOTE_BITS + 1) > VOTE_BITS)
+                    return false;
+
+        for (byte j = 0; j < count; ++j) {
+            byte a = copies[0][j], b = copies[1][j], c = copies[2][j];
+            out[j] = (a & b) | (a & c) | (b & c);
+        }
+        return true;
+    }
+};
+
+#endif
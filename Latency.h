@@ -0,0 +1,64 @@
+/*
+* How stale readings are by the time they are published
+*
+* Every frame is tagged with the time of the edge that ended it.  When the
+* reading it carried has gone out, the time since that edge is counted in a
+* LatencyHistogram: one bin per power of two milliseconds, byte counts
+* that are halved whenever LATENCY_WINDOW samples have come in, so the
+* percentiles follow the recent past rather than everything since boot.
+* Percentiles are interpolated within their bin.
+*/
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#define LATENCY_BINS    18   // bin 0 under 1 ms, bin b from 2^(b-1) ms, the last open ended
+#define LATENCY_WINDOW  128  // samples before the counts are halved
+
+class LatencyHistogram {
+protected:
+    byte bin[LATENCY_BINS];
+    byte total;
+
+    static unsigned long lower (byte b) { return b ? 1UL << (b - 1) : 0; }
+
+public:
+    LatencyHistogram () { clear(); }
+
+    void clear (void) {
+        for (byte b = 0; b < LATENCY_BINS; ++b)
+            bin[b] = 0;
+        total = 0;
+    }
+
+    void add (unsigned long us) {
+        unsigned long ms = us / 1000;
+        byte b = 0;
+        while (b < LATENCY_BINS - 1 && ms >= lower(b + 1))
+            ++b;
+        bin[b]++;
+        if (++total < LATENCY_WINDOW)
+            return;
+        total = 0;
+        for (b = 0; b < LATENCY_BINS; ++b)
+            total += bin[b] >>= 1;
+    }
+
+    byte count () const { return total; }
+
+    // ms that pct percent of the recent readings were published within
+    unsigned long percentile (byte pct) const {
+        word want = ((word)total * pct + 99) / 100;
+        word seen = 0;
+        for (byte b = 0; b < LATENCY_BINS; ++b) {
+            if (bin[b] && seen + bin[b] >= want) {
+                unsigned long lo = lower(b), hi = b ? lo * 2 : 1;
+                return lo + (hi - lo) * (want - seen) / bin[b];
+            }
+            seen += bin[b];
+        }
+        return 0;
+    }
+};
+
+#endif
@@ -0,0 +1,168 @@
+/*
+* Leveled logging that never waits on the UART
+*
+* At 38400 baud every character takes 26 us, so a decoded reading printed
+* straight to Serial held up decoding for a couple of ms.  Log lines are put
+* in a LOG_RING byte ring instead and loop() drains it into Serial with
+* logDrain(), only as much as the UART takes without blocking.  A line that
+* doesn't fit is dropped whole and counted, the ring only ever holds complete
+* lines.  One writer and one reader, head and tail are each only written by
+* one side, so nothing needs interrupts turned off.
+*
+* Messages below LOG_LEVEL are compiled out, F() strings included:
+*
+*   #define LOG_LEVEL LOG_LEVEL_WARN  // before including anything
+*   LOG_INFO(F("Blueline: "), packet);
+*   LOG_DEBUG(F("id="), logHex(id));
+*
+* On a host the lines go straight to Serial (stdout), which doesn't block.
+* Several decode threads log at once there, a mutex keeps their lines whole.
+*/
+
+#ifndef LOG_H
+#define LOG_H
+
+#define LOG_LEVEL_NONE   0
+#define LOG_LEVEL_ERROR  1
+#define LOG_LEVEL_WARN   2
+#define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL  LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_RING
+#define LOG_RING  128  // bytes, power of 2 up to 256
+#endif
+
+// print a number in hex within a log line
+struct LogHex {
+    unsigned long value;
+};
+
+static inline LogHex logHex (unsigned long value) {
+    LogHex h = { value };
+    return h;
+}
+
+#ifdef __AVR__
+
+class LogRing : public Print {
+protected:
+    byte buf[LOG_RING];
+    volatile byte head, tail;  // committed lines are tail..head
+    byte end;                  // end of the line being written
+    bool dropping;             // the line being written didn't fit
+
+public:
+    word dropped;  // lines lost to a full ring
+
+    LogRing () : head(0), tail(0), end(0), dropping(false), dropped(0) {}
+
+    virtual size_t write (uint8_t c) {
+        if (!dropping) {
+            byte next = (end + 1) & (LOG_RING - 1);
+            if (next == tail) {
+                dropping = true;
+                dropped++;
+            } else {
+                buf[end] = c;
+                end = next;
+            }
+        }
+        if (c == '\n') {
+            if (dropping)
+                end = head;  // throw the partial line away
+            else
+                head = end;
+            dropping = false;
+        }
+        return 1;
+    }
+    using Print::write;
+
+    // move what out takes without blocking
+    void drain (Print& out, int room) {
+        while (room-- > 0 && tail != head) {
+            out.write(buf[tail]);
+            tail = (tail + 1) & (LOG_RING - 1);
+        }
+    }
+};
+
+static LogRing logRing;
+
+static inline Print& logOut (void) { return logRing; }
+
+static inline void logDrain (HardwareSerial& serial) {
+    logRing.drain(serial, serial.availableForWrite());
+}
+
+static inline word logDropped (void) { return logRing.dropped; }
+
+#else
+
+#include <mutex>
+
+static std::mutex logLock;  // held for a whole line
+
+static inline Print& logOut (void) { return Serial; }
+template <typename S> static inline void logDrain (S&) {}
+static inline word logDropped (void) { return 0; }
+
+#endif
+
+static inline void logPrint (void) {}
+
+template <typename T, typename... Rest>
+static inline void logPrint (T value, Rest... rest);
+
+template <typename... Rest>
+static inline void logPrint (LogHex h, Rest... rest) {
+    logOut().print(h.value, HEX);
+    logPrint(rest...);
+}
+
+template <typename T, typename... Rest>
+static inline void logPrint (T value, Rest... rest) {
+    logOut().print(value);
+    logPrint(rest...);
+}
+
+template <typename... Args>
+static inline void logLine (Args... args) {
+#ifndef __AVR__
+    std::lock_guard<std::mutex> guard(logLock);
+#endif
+    logPrint(args...);
+    logOut().println();
+}
+
+#define LOG_NOTHING()  do {} while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...)  logLine(__VA_ARGS__)
+#else
+#define LOG_ERROR(...)  LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...)   logLine(__VA_ARGS__)
+#else
+#define LOG_WARN(...)   LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...)   logLine(__VA_ARGS__)
+#else
+#define LOG_INFO(...)   LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)  logLine(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...)  LOG_NOTHING()
+#endif
+
+#endif
@@ -0,0 +1,173 @@
+/*
+* MQTT-SN publisher over UDP
+*
+* A report over MQTT costs a TCP connect and a full CONNECT/PUBLISH exchange
+* for a few bytes of readings.  MQTT-SN (version 1.2) publishes in a single
+* datagram to a gateway that forwards to the broker.  Topics are sent as
+* predefined topic IDs, numbered from 1 in the order of mqttsn_topics, and
+* the gateway has to be set up with the same table.  Publishing to a topic
+* that isn't in it is dropped and counted.
+*
+* At QoS -1 nothing is needed before publishing.  QoS 0 needs a session,
+* connect() sends the CONNECT but doesn't wait for the CONNACK.  Neither
+* gets an acknowledgement, a lost datagram is a lost report.
+*
+* PUBLISH messages are batched, several to a datagram of at most
+* MQTTSN_DATAGRAM bytes, until flush().  A gateway that only reads the first
+* message of a datagram needs setBatching(false).  host/ooksngw.cpp is a
+* stand-in gateway for trying it out.
+*
+* UDP is EthernetUDP on the board, host/UdpSocket.h on a host.  The batch is
+* built in the UDP object's own packet buffer, the W5100's on the board.
+*/
+
+#ifndef MQTTSN_H
+#define MQTTSN_H
+
+#define MQTTSN_PORT      1884  // gateway's UDP port
+#define MQTTSN_DATAGRAM  192   // most bytes sent in one datagram
+
+#define MQTTSN_CONNECT   0x04
+#define MQTTSN_PUBLISH   0x0C
+
+#define MQTTSN_QOS_M1    0x60  // QoS -1 flag bits
+#define MQTTSN_QOS_0     0x00
+#define MQTTSN_CLEAN     0x04
+#define MQTTSN_PREDEF    0x01  // topic ID type
+
+// predefined topic IDs 1, 2, 3 ... in this order, keep in step with the gateway
+const char mqttsn_topics[] PROGMEM =
+    "blueline\0"               //  1
+    "acurite5n1\0"             //  2
+    "acurite592tx\0"           //  3
+    "blueline/summary\0"       //  4
+    "acurite5n1/summary\0"     //  5
+    "blueline/latency\0"       //  6
+    "acurite5n1/latency\0"     //  7
+    "acurite592tx/latency\0"   //  8
+    "ookDecoder\0"             //  9
+    "ookDecoder/recovered\0"   // 10
+    "ookDecoder/log\0"         // 11
+    "ookDecoder/capture\0";    // 12
+
+// topic ID of a topic name, 0 if it isn't predefined
+static inline word mqttsnTopicId (const char* topic) {
+    const char* entry = mqttsn_topics;
+    for (word id = 1; pgm_read_byte(entry); ++id) {
+        byte i = 0;
+        while (topic[i] && topic[i] == (char)pgm_read_byte(entry + i))
+            ++i;
+        if (!topic[i] && !pgm_read_byte(entry + i))
+            return id;
+        while (pgm_read_byte(entry))
+            ++entry;
+        ++entry;
+    }
+    return 0;
+}
+
+// topic name of a topic ID into name (size bytes), false if there's none
+static inline bool mqttsnTopicName (word id, char* name, byte size) {
+    const char* entry = mqttsn_topics;
+    for (; id > 1 && pgm_read_byte(entry); --id) {
+        while (pgm_read_byte(entry))
+            ++entry;
+        ++entry;
+    }
+    if (id != 1 || !pgm_read_byte(entry))
+        return false;
+    byte i = 0;
+    for (; i + 1 < size && pgm_read_byte(entry + i); ++i)
+        name[i] = pgm_read_byte(entry + i);
+    name[i] = 0;
+    return true;
+}
+
+template <typename UDP>
+class MqttSnClient {
+protected:
+    UDP& udp;
+    const byte* gateway;  // IPv4 address
+    word port;
+    byte qos;
+    bool batching;
+    word pending;  // bytes in the open datagram, 0 if none is open
+
+    void put (byte b) {
+        udp.write(&b, 1);
+        pending++;
+    }
+
+    // make room for a message of len bytes in the open datagram
+    void open (word len) {
+        if (pending && (!batching || pending + len > MQTTSN_DATAGRAM))
+            flush();
+        if (!pending)
+            udp.beginPacket(gateway, port);
+    }
+
+public:
+    word dropped;  // publishes to topics that aren't predefined or too long
+    word sent;     // datagrams
+
+    MqttSnClient (UDP& u, const byte* gatewayIp, word gatewayPort =MQTTSN_PORT)
+        : udp(u), gateway(gatewayIp), port(gatewayPort), qos(MQTTSN_QOS_M1), batching(true),
+          pending(0), dropped(0), sent(0) {}
+
+    // -1 or 0
+    void setQos (int level) {
+        qos = level < 0 ? MQTTSN_QOS_M1 : MQTTSN_QOS_0;
+    }
+
+    void setBatching (bool on) {
+        batching = on;
+    }
+
+    // start a session for QoS 0, with the keep alive disabled
+    void connect (const char* clientId) {
+        word len = 6 + strlen(clientId);
+        open(len);
+        put(len);
+        put(MQTTSN_CONNECT);
+        put(MQTTSN_CLEAN);
+        put(0x01);  // protocol ID
+        put(0);     // duration
+        put(0);
+        udp.write((const byte*)clientId, len - 6);
+        pending += len - 6;
+        flush();
+    }
+
+    // queue a PUBLISH, false if the topic isn't predefined or it's too long
+    bool publish (const char* topic, const char* payload) {
+        word id = mqttsnTopicId(topic);
+        word size = strlen(payload);
+        word len = 7 + size;
+        if (id == 0 || len > MQTTSN_DATAGRAM) {
+            dropped++;
+            return false;
+        }
+        open(len);
+        put(len);
+        put(MQTTSN_PUBLISH);
+        put(qos | MQTTSN_PREDEF);
+        put(id >> 8);
+        put(id & 0xFF);
+        put(0);  // message ID, unused below QoS 1
+        put(0);
+        udp.write((const byte*)payload, size);
+        pending += size;
+        return true;
+    }
+
+    // send the open datagram
+    void flush (void) {
+        if (!pending)
+            return;
+        udp.endPacket();
+        pending = 0;
+        sent++;
+    }
+};
+
+#endif
@@ -0,0 +1,344 @@
+/*
+* Decode loop shared by the sketch and the host tools.
+*
+* Pulses are pulled from a PulseSource and stepped through the combined
+* preamble recognizer.  A decoder only sees pulses once its preamble has been
+* recognized, until its frame completes or fails, and any completed frame is
+* handed to the decoder's packet decoder.  Blueline is rearmed after a frame
+* and keeps its bit window running to the end of the packet, so the frames
+* after the first don't depend on their preambles.  Reports go out
+* through a publish callback so the caller decides where they end up (MQTT on
+* the Arduino, stdout or a broker on a host).
+*
+* Every reading is timed from the edge that ended its frame until it has been
+* published, the latency of each protocol is published with the reports.
+*
+* An optional PulseCapture records the pulses as they come in, it's frozen
+* when a frame fails its check and can be dumped through the publish callback.
+*
+* Frames that pass their check can also be handed to a frame callback as raw
+* bytes, and frames from elsewhere fed back in with apply().  The host
+* aggregator uses this to merge several receivers into one set of readings.
+*/
+
+#ifndef OOK_RECEIVER_H
+#define OOK_RECEIVER_H
+
+#include "PulseSource.h"
+#include "DecodeOOK.h"
+#include "Blueline.h"
+#include "Acurite5n1.h"
+#include "Acurite592TX.h"
+#include "PreambleMatcher.h"
+#include "PulseCapture.h"
+#include "Latency.h"
+
+#define FRAME_GAP    2000  // us of silence that ends a frame
+#define PULSE_MIN    150   // shorter pulses are glitches and ignored
+#define PULSE_BATCH  8     // pulses pulled from the source per poll()
+#define FRAME_MAX    8     // longest raw frame of any protocol, in bytes
+#define DUMP_BYTES   32    // capture bytes per dump message
+
+enum { PROTO_BLUELINE, PROTO_ACURITE5N1, PROTO_ACURITE592TX, PROTO_COUNT };
+
+// a raw frame as it came off the air, before the packet decoder touched it
+struct Frame {
+    byte protocol;
+    byte len;
+    byte data[FRAME_MAX];
+    unsigned long time;  // micros() of the edge ending the frame
+};
+
+// what the decoders have learned that should survive a reset
+struct ReceiverState {
+    uint16_t txId;      // Blueline transmitter ID
+    uint16_t rainBase;  // Acurite 5n1 rain counter at the first reading
+    int16_t rainLast;   // and at the latest one, -1 if none yet
+};
+
+typedef void (*PublishFn)(const char* topic, const char* payload);
+typedef void (*FrameFn)(void* context, const Frame& frame);
+
+class OokReceiver {
+protected:
+    byte led;
+    bool idle;
+    byte lastHigh;
+    unsigned long lastEdge;
+    PreambleMatcher preamble;
+    Frame frame;
+    FrameFn frameFn;
+    void* frameContext;
+    PulseCapture* capture;
+    Clock* clock;
+    unsigned long readingTime[PROTO_COUNT];  // edge ending the frame of each latest reading
+
+    // a decoder gets the pulse while it's in a frame, or to start one when
+    // the pulse ended its preamble
+    template <typename Decoder>
+    void feed (Decoder& decoder, byte protocol, byte ended, const Pulse& p) {
+        if (!decoder.isActive()) {
+            if (!(ended & (1 << protocol)))
+                return;
+            decoder.prime(preamble_specs[protocol].count, p.high);
+        }
+        decoder.nextPulse(p.width, p.high);
+    }
+
+    // hand a frame that passed its check on as raw bytes, after voting the
+    // decoder's data holds the corrected frame
+    void forward (byte protocol, const DecodeOOK& decoder, bool ok) {
+        if (ok)
+            readingTime[protocol] = lastEdge;
+        if (!ok && capture)
+            capture->freeze();
+        if (!ok || !frameFn)
+            return;
+        byte len;
+        const byte* bytes = decoder.getData(len);
+        frame.protocol = protocol;
+        frame.len = len < FRAME_MAX ? len : FRAME_MAX;
+        memcpy(frame.data, bytes, frame.len);
+        frame.time = lastEdge;
+        frameFn(frameContext, frame);
+    }
+
+public:
+    Blueline blueline;
+    Acurite5n1 acurite5n1;
+    Acurite592TX acurite592tx;
+    LatencyHistogram latency[PROTO_COUNT];  // frame end to published reading
+
+    OokReceiver (byte ledPin)
+        : led(ledPin), idle(true), lastHigh(0), lastEdge(0), frameFn(0), frameContext(0), capture(0), clock(&systemClock) {
+        for (byte i = 0; i < PROTO_COUNT; ++i)
+            readingTime[i] = 0;
+    }
+
+    // call fn with every frame that passes its check
+    void onFrame (FrameFn fn, void* context) {
+        frameFn = fn;
+        frameContext = context;
+    }
+
+    // time for the decoders, a VirtualClock follows the pulse timestamps
+    void setClock (Clock* c) {
+        clock = c;
+        blueline.setClock(c);
+        acurite5n1.setClock(c);
+        acurite592tx.setClock(c);
+    }
+
+    // record pulses in c, frozen on the first frame that fails its check
+    void onCapture (PulseCapture* c) {
+        capture = c;
+    }
+
+    // drain whatever the source has buffered
+    void poll (PulseSource& source) {
+        Pulse buf[PULSE_BATCH];
+        byte n = source.read(buf, PULSE_BATCH);
+        for (byte i = 0; i < n; ++i)
+            nextPulse(buf[i]);
+        if (n == 0 && !idle && source.silent(FRAME_GAP))
+            gap();
+    }
+
+    // as poll(), with the preamble symbols of the whole batch worked out in
+    // one go by classify (host/PulseClassifier.h)
+    template <typename Classifier>
+    void poll (PulseSource& source, const Classifier& classify) {
+        Pulse buf[Classifier::BATCH];
+        byte sym[Classifier::BATCH];
+        byte n = source.read(buf, Classifier::BATCH);
+        classify(buf, sym, n);
+        for (byte i = 0; i < n; ++i)
+            nextPulse(buf[i], sym[i]);
+        if (n == 0 && !idle && source.silent(FRAME_GAP))
+            gap();
+    }
+
+    // sym is the pulse's preamble symbol if it's known already
+    void nextPulse (const Pulse& p, byte sym = SYMBOL_NONE) {
+        lastEdge = p.time;
+        clock->tick(p.time);
+        if (p.width >= FRAME_GAP) {
+            gap();
+        } else if (p.width > PULSE_MIN) {
+            // same level twice means a lost edge, start over
+            if (!idle && p.high == lastHigh)
+                preamble.reset();
+            idle = false;
+            lastHigh = p.high;
+            if (capture)
+                capture->pulse(p.width, p.high);
+            byte ended = sym == SYMBOL_NONE ? preamble.next(p.width, p.high) : preamble.step(sym);
+            feed(blueline, PROTO_BLUELINE, ended, p);
+            feed(acurite5n1, PROTO_ACURITE5N1, ended, p);
+            feed(acurite592tx, PROTO_ACURITE592TX, ended, p);
+            process();
+        }
+    }
+
+    // silence on the air ends whatever frame was in progress, either seen
+    // as an overlong pulse or while still waiting for the next edge
+    void gap (void) {
+        preamble.reset();
+        if (capture)
+            capture->gap();
+        if (!idle) {
+            blueline.nextGap();
+            acurite5n1.nextGap();
+            acurite592tx.nextGap();
+            process(true);
+        }
+        idle = true;
+    }
+
+    // hand completed frames to the packet decoders, ended when silence
+    // completed them
+    void process (bool ended =false) {
+        if (blueline.isDone()) {
+          //turn on led
+          digitalWrite(led, HIGH);
+          forward(PROTO_BLUELINE, blueline, blueline.decodeRxPacket());
+          //blueline.PrintRaw();
+          if (ended)
+            blueline.resetDecoder();
+          else
+            blueline.rearm();
+          digitalWrite(led, LOW);
+        }
+        if (acurite5n1.isDone()) {
+          //turn on led
+          digitalWrite(led, HIGH);
+          forward(PROTO_ACURITE5N1, acurite5n1, acurite5n1.DecodePacket());
+          //acurite5n1.PrintRaw();
+          acurite5n1.resetDecoder();
+          digitalWrite(led, LOW);
+        }
+        if (acurite592tx.isDone()) {
+          //turn on led
+          digitalWrite(led, HIGH);
+          forward(PROTO_ACURITE592TX, acurite592tx, acurite592tx.DecodePacket());
+          //acurite592tx.PrintRaw();
+          acurite592tx.resetDecoder();
+          digitalWrite(led, LOW);
+        }
+    }
+
+    // decode a raw frame received elsewhere as if it had come off the air
+    bool apply (const Frame& f) {
+        bool ok = false;
+        switch (f.protocol) {
+            case PROTO_BLUELINE:
+                blueline.setData(f.data, f.len);
+                ok = blueline.decodeRxPacket();
+                blueline.resetDecoder();
+                break;
+            case PROTO_ACURITE5N1:
+                acurite5n1.setData(f.data, f.len);
+                ok = acurite5n1.DecodePacket();
+                acurite5n1.resetDecoder();
+                break;
+            case PROTO_ACURITE592TX:
+                acurite592tx.setData(f.data, f.len);
+                ok = acurite592tx.DecodePacket();
+                acurite592tx.resetDecoder();
+                break;
+        }
+        if (ok)
+            readingTime[f.protocol] = f.time;
+        return ok;
+    }
+
+    void getState (ReceiverState& state) {
+        unsigned int base;
+        int last;
+        acurite5n1.getRainCounters(base, last);
+        state.txId = blueline.txId();
+        state.rainBase = base;
+        state.rainLast = last;
+    }
+
+    void setState (const ReceiverState& state) {
+        blueline.setTxId(state.txId);
+        acurite5n1.setRainCounters(state.rainBase, state.rainLast);
+    }
+
+    // publish the capture as hex, DUMP_BYTES to a message between a header
+    // and "end", then let it record again
+    void dumpCapture (char* packet, PublishFn publish) {
+        if (!capture)
+            return;
+        word first = capture->oldest(), held = capture->held();
+        sprintf(packet, "begin,Frozen=%u,Freezes=%u,Bytes=%u",
+          capture->isFrozen(), capture->freezes, held - first);
+        publish("ookDecoder/capture", packet);
+        for (word i = first; i < held; i += DUMP_BYTES) {
+          char* p = packet;
+          for (word j = i; j < held && j < i + DUMP_BYTES; ++j)
+            p += sprintf(p, "%02X", capture->at(j));
+          publish("ookDecoder/capture", packet);
+        }
+        publish("ookDecoder/capture", "end");
+        capture->resume();
+    }
+
+    // the latest reading of protocol has gone out
+    void published (byte protocol) {
+        latency[protocol].add((uint32_t)(clock->micros() - readingTime[protocol]));
+    }
+
+    // p50 and p99 in ms of the recent readings of protocol
+    void reportLatency (char* packet, PublishFn publish, const char* topic, byte protocol) {
+        if (latency[protocol].count() == 0)
+          return;
+        sprintf(packet, "P50=%lu,P99=%lu,Count=%u", latency[protocol].percentile(50),
+          latency[protocol].percentile(99), latency[protocol].count());
+        publish(topic, packet);
+    }
+
+    // publish the latest reading of every sensor that has one, a summary of
+    // all readings since the last report, how long readings took to get out,
+    // and how many frames were recovered by voting over repeats or by
+    // correction so far
+    void report (char* packet, PublishFn publish) {
+        blueline.MQTTreport(packet);
+        if (strlen(packet) > 0) {
+          publish("blueline", packet);
+          published(PROTO_BLUELINE);
+        }
+
+        blueline.MQTTsummary(packet);
+        if (strlen(packet) > 0)
+          publish("blueline/summary", packet);
+
+        acurite5n1.MQTTreport(packet);
+        if (strlen(packet) > 0) {
+          publish("acurite5n1", packet);
+          published(PROTO_ACURITE5N1);
+        }
+
+        acurite5n1.MQTTsummary(packet);
+        if (strlen(packet) > 0)
+          publish("acurite5n1/summary", packet);
+
+        acurite592tx.MQTTreport(packet);
+        if (strlen(packet) > 0) {
+          publish("acurite592tx", packet);
+          published(PROTO_ACURITE592TX);
+        }
+
+        reportLatency(packet, publish, "blueline/latency", PROTO_BLUELINE);
+        reportLatency(packet, publish, "acurite5n1/latency", PROTO_ACURITE5N1);
+        reportLatency(packet, publish, "acurite592tx/latency", PROTO_ACURITE592TX);
+
+        sprintf(packet, "Blueline=%u,Acurite5n1=%u,Acurite592TX=%u,BluelineCorrected=%u",
+          blueline.recovered(), acurite5n1.recovered(), acurite592tx.recovered(),
+          blueline.corrected());
+        publish("ookDecoder/recovered", packet);
+    }
+};
+
+#endif
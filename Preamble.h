@@ -0,0 +1,76 @@
+/*
+* Preamble definitions shared by the combined preamble recognizer
+*
+* Each protocol's preamble is described the same way: a run of at least count
+* pulses from the run buckets, the first of them at one of runStart levels,
+* ended by a pulse from the end buckets at one of endLevels.  Pulse widths are
+* put in PREAMBLE_BUCKETS buckets whose edges are every width any of the
+* preambles tells apart.
+*
+* host/ookpreamble.cpp turns these into the table in PreambleTable.h, run
+* it again after changing anything here:
+*
+*   g++ -O2 -Ihost -o ookpreamble host/ookpreamble.cpp
+*   ./ookpreamble > PreambleTable.h
+*/
+
+#ifndef PREAMBLE_H
+#define PREAMBLE_H
+
+#define PREAMBLE_BUCKETS  9
+#define PREAMBLE_ALL      0x1FF  // every bucket
+
+#define BUCKET(b)    (1 << (b))
+#define LEVELS_LOW   1
+#define LEVELS_HIGH  2
+#define LEVELS_ANY   3
+
+// lowest width of buckets 1 and up, bucket 0 is everything shorter
+const word preamble_bounds[PREAMBLE_BUCKETS - 1] PROGMEM = {
+    375,   // 1: Blueline short
+    501,   // 2: 592TX sync
+    576,   // 3: 592TX and 5n1 sync
+    700,   // 4: 5n1 sync
+    725,   // 5: Blueline short
+    750,   // 6: too long for any
+    1251,  // 7: Blueline long
+    1626   // 8: too long for any
+};
+
+struct PreambleSpec {
+    word run;        // buckets of the preamble pulses
+    byte runStart;   // levels the first of them may have
+    byte count;      // preamble pulses needed, counting stops there
+    word end;        // buckets of the pulse ending the preamble
+    byte endLevels;  // levels that pulse may have
+};
+
+// in PROTO_* order
+const PreambleSpec preamble_specs[] = {
+    // Blueline: 7 short pulses starting high, then a long low
+    { BUCKET(1) | BUCKET(2) | BUCKET(3) | BUCKET(4) | BUCKET(5), LEVELS_HIGH, 7,
+      BUCKET(7), LEVELS_LOW },
+    // Acurite 5n1: 3 or more syncs, the first high data pulse ends them
+    { BUCKET(3) | BUCKET(4), LEVELS_ANY, 3,
+      PREAMBLE_ALL & ~(BUCKET(3) | BUCKET(4)), LEVELS_HIGH },
+    // Acurite 592TX: 6 or more syncs, the first high data pulse ends them
+    { BUCKET(2) | BUCKET(3), LEVELS_ANY, 6,
+      PREAMBLE_ALL & ~(BUCKET(2) | BUCKET(3)), LEVELS_HIGH },
+};
+
+#define PREAMBLE_PROTOCOLS  (sizeof preamble_specs / sizeof preamble_specs[0])
+
+// one protocol's preamble counter after a pulse, done is set when the pulse
+// ends a complete preamble
+inline byte preambleCount (const PreambleSpec& p, byte count, byte bucket, byte high, bool& done) {
+    byte levels = high ? LEVELS_HIGH : LEVELS_LOW;
+    done = false;
+    if (count >= p.count && (p.end & BUCKET(bucket)) && (p.endLevels & levels))
+        done = true;
+    else if (count > 0 && (p.run & BUCKET(bucket)))
+        return count < p.count ? count + 1 : count;
+    // anything else may start a new preamble
+    return (p.run & BUCKET(bucket)) && (p.runStart & levels) ? 1 : 0;
+}
+
+#endif
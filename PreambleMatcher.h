@@ -0,0 +1,53 @@
+/*
+* Combined preamble recognizer
+*
+* Instead of every decoder checking every pulse for its own preamble, one
+* automaton watches for all of them at once.  Each pulse is bucketed by width,
+* the bucket's class and the line level make a symbol, and the symbol takes
+* one step in the table compiled from Preamble.h.  The step also tells which
+* protocols' preambles the pulse completed, only those decoders are started.
+*/
+
+#ifndef PREAMBLE_MATCHER_H
+#define PREAMBLE_MATCHER_H
+
+#include "Preamble.h"
+#include "PreambleTable.h"
+
+#define SYMBOL_NONE  0xFF  // pulse not classified yet
+
+class PreambleMatcher {
+protected:
+    byte state;
+
+public:
+    PreambleMatcher () : state(0) {}
+
+    void reset (void) { state = 0; }
+
+    static byte bucket (word width) {
+        byte b = 0;
+        while (b < PREAMBLE_BUCKETS - 1 && width >= pgm_read_word(&preamble_bounds[b]))
+            ++b;
+        return b;
+    }
+
+    static byte symbol (word width, byte high) {
+        return pgm_read_byte(&preamble_class[bucket(width)]) * 2 + (high ? 1 : 0);
+    }
+
+    // step over one pulse, returns a bit per protocol (1 << PROTO_*) whose
+    // preamble it ended
+    byte next (word width, byte high) {
+        return step(symbol(width, high));
+    }
+
+    // the same with the pulse's symbol already worked out
+    byte step (byte sym) {
+        byte ended = pgm_read_byte(&preamble_ready[state]) & pgm_read_byte(&preamble_ends[sym]);
+        state = pgm_read_byte(&preamble_next[state][sym]);
+        return ended;
+    }
+};
+
+#endif
@@ -0,0 +1,269 @@
+/*
+* Generated by host/ookpreamble.cpp from Preamble.h, don't edit.
+*
+* 224 states over 12 symbols (6 width classes by line level).
+*/
+
+#ifndef PREAMBLE_TABLE_H
+#define PREAMBLE_TABLE_H
+
+#define PREAMBLE_STATES   224
+#define PREAMBLE_SYMBOLS  12
+
+// width class of each bucket, symbol = class * 2 + level
+const byte preamble_class[PREAMBLE_BUCKETS] PROGMEM = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x01, 0x00, 0x05, 0x00,
+};
+
+// protocols whose preamble ends with this symbol
+const byte preamble_ends[PREAMBLE_SYMBOLS] PROGMEM = {
+  0x00, 0x06, 0x00, 0x06, 0x00, 0x02, 0x00, 0x00, 0x00, 0x04, 0x01, 0x06,
+};
+
+// protocols whose preamble is complete in this state
+const byte preamble_ready[PREAMBLE_STATES] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x02, 0x02, 0x02,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x02, 0x02, 0x02,
+  0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x02, 0x02, 0x02, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x02, 0x02, 0x02, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x02, 0x02, 0x02,
+  0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+  0x04, 0x04, 0x04, 0x04, 0x06, 0x06, 0x06, 0x06, 0x04, 0x04, 0x04, 0x06, 0x04, 0x04, 0x04, 0x06,
+  0x04, 0x04, 0x04, 0x06, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x03, 0x03, 0x03, 0x03, 0x01, 0x01, 0x01, 0x03, 0x01, 0x01, 0x01, 0x03, 0x05, 0x05, 0x05, 0x07,
+};
+
+// next state by state and symbol
+const byte preamble_next[PREAMBLE_STATES][PREAMBLE_SYMBOLS] PROGMEM = {
+  {   0,   0,   0,   1,   2,   3,   4,   5,   6,   7,   0,   0, },  // 0: 0 0 0
+  {   0,   0,   8,   8,   9,   9,  10,  10,  11,  11,   0,   0, },  // 1: 1 0 0
+  {   0,   0,   0,   1,  12,  13,  14,  15,   6,   7,   0,   0, },  // 2: 0 0 1
+  {   0,   0,   8,   8,  16,  16,  17,  17,  11,  11,   0,   0, },  // 3: 1 0 1
+  {   0,   0,   0,   1,  12,  13,  18,  19,  20,  21,   0,   0, },  // 4: 0 1 1
+  {   0,   0,   8,   8,  16,  16,  22,  22,  23,  23,   0,   0, },  // 5: 1 1 1
+  {   0,   0,   0,   1,   2,   3,  24,  25,  20,  21,   0,   0, },  // 6: 0 1 0
+  {   0,   0,   8,   8,   9,   9,  26,  26,  23,  23,   0,   0, },  // 7: 1 1 0
+  {   0,   0,  27,  27,  28,  28,  29,  29,  30,  30,   0,   0, },  // 8: 2 0 0
+  {   0,   0,  27,  27,  31,  31,  32,  32,  30,  30,   0,   0, },  // 9: 2 0 1
+  {   0,   0,  27,  27,  31,  31,  33,  33,  34,  34,   0,   0, },  // 10: 2 1 1
+  {   0,   0,  27,  27,  28,  28,  35,  35,  34,  34,   0,   0, },  // 11: 2 1 0
+  {   0,   0,   0,   1,  36,  37,  38,  39,   6,   7,   0,   0, },  // 12: 0 0 2
+  {   0,   0,   8,   8,  40,  40,  41,  41,  11,  11,   0,   0, },  // 13: 1 0 2
+  {   0,   0,   0,   1,  36,  37,  42,  43,  20,  21,   0,   0, },  // 14: 0 1 2
+  {   0,   0,   8,   8,  40,  40,  44,  44,  23,  23,   0,   0, },  // 15: 1 1 2
+  {   0,   0,  27,  27,  45,  45,  46,  46,  30,  30,   0,   0, },  // 16: 2 0 2
+  {   0,   0,  27,  27,  45,  45,  47,  47,  34,  34,   0,   0, },  // 17: 2 1 2
+  {   0,   0,   0,   1,  36,  37,  48,  49,  50,  51,   0,   0, },  // 18: 0 2 2
+  {   0,   0,   8,   8,  40,  40,  52,  52,  53,  53,   0,   0, },  // 19: 1 2 2
+  {   0,   0,   0,   1,   2,   3,  54,  55,  50,  51,   0,   0, },  // 20: 0 2 0
+  {   0,   0,   8,   8,   9,   9,  56,  56,  53,  53,   0,   0, },  // 21: 1 2 0
+  {   0,   0,  27,  27,  45,  45,  57,  57,  58,  58,   0,   0, },  // 22: 2 2 2
+  {   0,   0,  27,  27,  28,  28,  59,  59,  58,  58,   0,   0, },  // 23: 2 2 0
+  {   0,   0,   0,   1,  12,  13,  60,  61,  50,  51,   0,   0, },  // 24: 0 2 1
+  {   0,   0,   8,   8,  16,  16,  62,  62,  53,  53,   0,   0, },  // 25: 1 2 1
+  {   0,   0,  27,  27,  31,  31,  63,  63,  58,  58,   0,   0, },  // 26: 2 2 1
+  {   0,   0,  64,  64,  65,  65,  66,  66,  67,  67,   0,   0, },  // 27: 3 0 0
+  {   0,   0,  64,  64,  68,  68,  69,  69,  67,  67,   0,   0, },  // 28: 3 0 1
+  {   0,   0,  64,  64,  68,  68,  70,  70,  71,  71,   0,   0, },  // 29: 3 1 1
+  {   0,   0,  64,  64,  65,  65,  72,  72,  71,  71,   0,   0, },  // 30: 3 1 0
+  {   0,   0,  64,  64,  73,  73,  74,  74,  67,  67,   0,   0, },  // 31: 3 0 2
+  {   0,   0,  64,  64,  73,  73,  75,  75,  71,  71,   0,   0, },  // 32: 3 1 2
+  {   0,   0,  64,  64,  73,  73,  76,  76,  77,  77,   0,   0, },  // 33: 3 2 2
+  {   0,   0,  64,  64,  65,  65,  78,  78,  77,  77,   0,   0, },  // 34: 3 2 0
+  {   0,   0,  64,  64,  68,  68,  79,  79,  77,  77,   0,   0, },  // 35: 3 2 1
+  {   0,   0,   0,   1,  80,  81,  82,  83,   6,   7,   0,   0, },  // 36: 0 0 3
+  {   0,   0,   8,   8,  84,  84,  85,  85,  11,  11,   0,   0, },  // 37: 1 0 3
+  {   0,   0,   0,   1,  80,  81,  86,  87,  20,  21,   0,   0, },  // 38: 0 1 3
+  {   0,   0,   8,   8,  84,  84,  88,  88,  23,  23,   0,   0, },  // 39: 1 1 3
+  {   0,   0,  27,  27,  89,  89,  90,  90,  30,  30,   0,   0, },  // 40: 2 0 3
+  {   0,   0,  27,  27,  89,  89,  91,  91,  34,  34,   0,   0, },  // 41: 2 1 3
+  {   0,   0,   0,   1,  80,  81,  92,  93,  50,  51,   0,   0, },  // 42: 0 2 3
+  {   0,   0,   8,   8,  84,  84,  94,  94,  53,  53,   0,   0, },  // 43: 1 2 3
+  {   0,   0,  27,  27,  89,  89,  95,  95,  58,  58,   0,   0, },  // 44: 2 2 3
+  {   0,   0,  64,  64,  96,  96,  97,  97,  67,  67,   0,   0, },  // 45: 3 0 3
+  {   0,   0,  64,  64,  96,  96,  98,  98,  71,  71,   0,   0, },  // 46: 3 1 3
+  {   0,   0,  64,  64,  96,  96,  99,  99,  77,  77,   0,   0, },  // 47: 3 2 3
+  {   0,   0,   0,   1,  80,  81,  92,  93,  50,  51,   0,   0, },  // 48: 0 3 3
+  {   0,   0,   8,   8,  84,  84,  94,  94,  53,  53,   0,   0, },  // 49: 1 3 3
+  {   0,   0,   0,   1,   2,   3,  54,  55,  50,  51,   0,   0, },  // 50: 0 3 0
+  {   0,   0,   8,   8,   9,   9,  56,  56,  53,  53,   0,   0, },  // 51: 1 3 0
+  {   0,   0,  27,  27,  89,  89,  95,  95,  58,  58,   0,   0, },  // 52: 2 3 3
+  {   0,   0,  27,  27,  28,  28,  59,  59,  58,  58,   0,   0, },  // 53: 2 3 0
+  {   0,   0,   0,   1,  12,  13,  60,  61,  50,  51,   0,   0, },  // 54: 0 3 1
+  {   0,   0,   8,   8,  16,  16,  62,  62,  53,  53,   0,   0, },  // 55: 1 3 1
+  {   0,   0,  27,  27,  31,  31,  63,  63,  58,  58,   0,   0, },  // 56: 2 3 1
+  {   0,   0,  64,  64,  96,  96,  99,  99,  77,  77,   0,   0, },  // 57: 3 3 3
+  {   0,   0,  64,  64,  65,  65,  78,  78,  77,  77,   0,   0, },  // 58: 3 3 0
+  {   0,   0,  64,  64,  68,  68,  79,  79,  77,  77,   0,   0, },  // 59: 3 3 1
+  {   0,   0,   0,   1,  36,  37,  48,  49,  50,  51,   0,   0, },  // 60: 0 3 2
+  {   0,   0,   8,   8,  40,  40,  52,  52,  53,  53,   0,   0, },  // 61: 1 3 2
+  {   0,   0,  27,  27,  45,  45,  57,  57,  58,  58,   0,   0, },  // 62: 2 3 2
+  {   0,   0,  64,  64,  73,  73,  76,  76,  77,  77,   0,   0, },  // 63: 3 3 2
+  {   0,   0, 100, 100, 101, 101, 102, 102, 103, 103,   0,   0, },  // 64: 4 0 0
+  {   0,   0, 100, 100, 104, 104, 105, 105, 103, 103,   0,   0, },  // 65: 4 0 1
+  {   0,   0, 100, 100, 104, 104, 106, 106, 107, 107,   0,   0, },  // 66: 4 1 1
+  {   0,   0, 100, 100, 101, 101, 108, 108, 107, 107,   0,   0, },  // 67: 4 1 0
+  {   0,   0, 100, 100, 109, 109, 110, 110, 103, 103,   0,   0, },  // 68: 4 0 2
+  {   0,   0, 100, 100, 109, 109, 111, 111, 107, 107,   0,   0, },  // 69: 4 1 2
+  {   0,   0, 100, 100, 109, 109, 112, 112, 113, 113,   0,   0, },  // 70: 4 2 2
+  {   0,   0, 100, 100, 101, 101, 114, 114, 113, 113,   0,   0, },  // 71: 4 2 0
+  {   0,   0, 100, 100, 104, 104, 115, 115, 113, 113,   0,   0, },  // 72: 4 2 1
+  {   0,   0, 100, 100, 116, 116, 117, 117, 103, 103,   0,   0, },  // 73: 4 0 3
+  {   0,   0, 100, 100, 116, 116, 118, 118, 107, 107,   0,   0, },  // 74: 4 1 3
+  {   0,   0, 100, 100, 116, 116, 119, 119, 113, 113,   0,   0, },  // 75: 4 2 3
+  {   0,   0, 100, 100, 116, 116, 119, 119, 113, 113,   0,   0, },  // 76: 4 3 3
+  {   0,   0, 100, 100, 101, 101, 114, 114, 113, 113,   0,   0, },  // 77: 4 3 0
+  {   0,   0, 100, 100, 104, 104, 115, 115, 113, 113,   0,   0, },  // 78: 4 3 1
+  {   0,   0, 100, 100, 109, 109, 112, 112, 113, 113,   0,   0, },  // 79: 4 3 2
+  {   0,   0,   0,   1, 120, 121, 122, 123,   6,   7,   0,   0, },  // 80: 0 0 4
+  {   0,   0,   8,   8, 124, 124, 125, 125,  11,  11,   0,   0, },  // 81: 1 0 4
+  {   0,   0,   0,   1, 120, 121, 126, 127,  20,  21,   0,   0, },  // 82: 0 1 4
+  {   0,   0,   8,   8, 124, 124, 128, 128,  23,  23,   0,   0, },  // 83: 1 1 4
+  {   0,   0,  27,  27, 129, 129, 130, 130,  30,  30,   0,   0, },  // 84: 2 0 4
+  {   0,   0,  27,  27, 129, 129, 131, 131,  34,  34,   0,   0, },  // 85: 2 1 4
+  {   0,   0,   0,   1, 120, 121, 132, 133,  50,  51,   0,   0, },  // 86: 0 2 4
+  {   0,   0,   8,   8, 124, 124, 134, 134,  53,  53,   0,   0, },  // 87: 1 2 4
+  {   0,   0,  27,  27, 129, 129, 135, 135,  58,  58,   0,   0, },  // 88: 2 2 4
+  {   0,   0,  64,  64, 136, 136, 137, 137,  67,  67,   0,   0, },  // 89: 3 0 4
+  {   0,   0,  64,  64, 136, 136, 138, 138,  71,  71,   0,   0, },  // 90: 3 1 4
+  {   0,   0,  64,  64, 136, 136, 139, 139,  77,  77,   0,   0, },  // 91: 3 2 4
+  {   0,   0,   0,   1, 120, 121, 132, 133,  50,  51,   0,   0, },  // 92: 0 3 4
+  {   0,   0,   8,   8, 124, 124, 134, 134,  53,  53,   0,   0, },  // 93: 1 3 4
+  {   0,   0,  27,  27, 129, 129, 135, 135,  58,  58,   0,   0, },  // 94: 2 3 4
+  {   0,   0,  64,  64, 136, 136, 139, 139,  77,  77,   0,   0, },  // 95: 3 3 4
+  {   0,   0, 100, 100, 140, 140, 141, 141, 103, 103,   0,   0, },  // 96: 4 0 4
+  {   0,   0, 100, 100, 140, 140, 142, 142, 107, 107,   0,   0, },  // 97: 4 1 4
+  {   0,   0, 100, 100, 140, 140, 143, 143, 113, 113,   0,   0, },  // 98: 4 2 4
+  {   0,   0, 100, 100, 140, 140, 143, 143, 113, 113,   0,   0, },  // 99: 4 3 4
+  {   0,   0, 144, 144, 145, 145, 146, 146, 147, 147,   0,   0, },  // 100: 5 0 0
+  {   0,   0, 144, 144, 148, 148, 149, 149, 147, 147,   0,   0, },  // 101: 5 0 1
+  {   0,   0, 144, 144, 148, 148, 150, 150, 151, 151,   0,   0, },  // 102: 5 1 1
+  {   0,   0, 144, 144, 145, 145, 152, 152, 151, 151,   0,   0, },  // 103: 5 1 0
+  {   0,   0, 144, 144, 153, 153, 154, 154, 147, 147,   0,   0, },  // 104: 5 0 2
+  {   0,   0, 144, 144, 153, 153, 155, 155, 151, 151,   0,   0, },  // 105: 5 1 2
+  {   0,   0, 144, 144, 153, 153, 156, 156, 157, 157,   0,   0, },  // 106: 5 2 2
+  {   0,   0, 144, 144, 145, 145, 158, 158, 157, 157,   0,   0, },  // 107: 5 2 0
+  {   0,   0, 144, 144, 148, 148, 159, 159, 157, 157,   0,   0, },  // 108: 5 2 1
+  {   0,   0, 144, 144, 160, 160, 161, 161, 147, 147,   0,   0, },  // 109: 5 0 3
+  {   0,   0, 144, 144, 160, 160, 162, 162, 151, 151,   0,   0, },  // 110: 5 1 3
+  {   0,   0, 144, 144, 160, 160, 163, 163, 157, 157,   0,   0, },  // 111: 5 2 3
+  {   0,   0, 144, 144, 160, 160, 163, 163, 157, 157,   0,   0, },  // 112: 5 3 3
+  {   0,   0, 144, 144, 145, 145, 158, 158, 157, 157,   0,   0, },  // 113: 5 3 0
+  {   0,   0, 144, 144, 148, 148, 159, 159, 157, 157,   0,   0, },  // 114: 5 3 1
+  {   0,   0, 144, 144, 153, 153, 156, 156, 157, 157,   0,   0, },  // 115: 5 3 2
+  {   0,   0, 144, 144, 164, 164, 165, 165, 147, 147,   0,   0, },  // 116: 5 0 4
+  {   0,   0, 144, 144, 164, 164, 166, 166, 151, 151,   0,   0, },  // 117: 5 1 4
+  {   0,   0, 144, 144, 164, 164, 167, 167, 157, 157,   0,   0, },  // 118: 5 2 4
+  {   0,   0, 144, 144, 164, 164, 167, 167, 157, 157,   0,   0, },  // 119: 5 3 4
+  {   0,   0,   0,   1, 168, 169, 170, 171,   6,   7,   0,   0, },  // 120: 0 0 5
+  {   0,   0,   8,   8, 172, 172, 173, 173,  11,  11,   0,   0, },  // 121: 1 0 5
+  {   0,   0,   0,   1, 168, 169, 174, 175,  20,  21,   0,   0, },  // 122: 0 1 5
+  {   0,   0,   8,   8, 172, 172, 176, 176,  23,  23,   0,   0, },  // 123: 1 1 5
+  {   0,   0,  27,  27, 177, 177, 178, 178,  30,  30,   0,   0, },  // 124: 2 0 5
+  {   0,   0,  27,  27, 177, 177, 179, 179,  34,  34,   0,   0, },  // 125: 2 1 5
+  {   0,   0,   0,   1, 168, 169, 180, 181,  50,  51,   0,   0, },  // 126: 0 2 5
+  {   0,   0,   8,   8, 172, 172, 182, 182,  53,  53,   0,   0, },  // 127: 1 2 5
+  {   0,   0,  27,  27, 177, 177, 183, 183,  58,  58,   0,   0, },  // 128: 2 2 5
+  {   0,   0,  64,  64, 184, 184, 185, 185,  67,  67,   0,   0, },  // 129: 3 0 5
+  {   0,   0,  64,  64, 184, 184, 186, 186,  71,  71,   0,   0, },  // 130: 3 1 5
+  {   0,   0,  64,  64, 184, 184, 187, 187,  77,  77,   0,   0, },  // 131: 3 2 5
+  {   0,   0,   0,   1, 168, 169, 180, 181,  50,  51,   0,   0, },  // 132: 0 3 5
+  {   0,   0,   8,   8, 172, 172, 182, 182,  53,  53,   0,   0, },  // 133: 1 3 5
+  {   0,   0,  27,  27, 177, 177, 183, 183,  58,  58,   0,   0, },  // 134: 2 3 5
+  {   0,   0,  64,  64, 184, 184, 187, 187,  77,  77,   0,   0, },  // 135: 3 3 5
+  {   0,   0, 100, 100, 188, 188, 189, 189, 103, 103,   0,   0, },  // 136: 4 0 5
+  {   0,   0, 100, 100, 188, 188, 190, 190, 107, 107,   0,   0, },  // 137: 4 1 5
+  {   0,   0, 100, 100, 188, 188, 191, 191, 113, 113,   0,   0, },  // 138: 4 2 5
+  {   0,   0, 100, 100, 188, 188, 191, 191, 113, 113,   0,   0, },  // 139: 4 3 5
+  {   0,   0, 144, 144, 192, 192, 193, 193, 147, 147,   0,   0, },  // 140: 5 0 5
+  {   0,   0, 144, 144, 192, 192, 194, 194, 151, 151,   0,   0, },  // 141: 5 1 5
+  {   0,   0, 144, 144, 192, 192, 195, 195, 157, 157,   0,   0, },  // 142: 5 2 5
+  {   0,   0, 144, 144, 192, 192, 195, 195, 157, 157,   0,   0, },  // 143: 5 3 5
+  {   0,   0, 196, 196, 197, 197, 198, 198, 199, 199,   0,   0, },  // 144: 6 0 0
+  {   0,   0, 196, 196, 200, 200, 201, 201, 199, 199,   0,   0, },  // 145: 6 0 1
+  {   0,   0, 196, 196, 200, 200, 202, 202, 203, 203,   0,   0, },  // 146: 6 1 1
+  {   0,   0, 196, 196, 197, 197, 204, 204, 203, 203,   0,   0, },  // 147: 6 1 0
+  {   0,   0, 196, 196, 205, 205, 206, 206, 199, 199,   0,   0, },  // 148: 6 0 2
+  {   0,   0, 196, 196, 205, 205, 207, 207, 203, 203,   0,   0, },  // 149: 6 1 2
+  {   0,   0, 196, 196, 205, 205, 208, 208, 209, 209,   0,   0, },  // 150: 6 2 2
+  {   0,   0, 196, 196, 197, 197, 210, 210, 209, 209,   0,   0, },  // 151: 6 2 0
+  {   0,   0, 196, 196, 200, 200, 211, 211, 209, 209,   0,   0, },  // 152: 6 2 1
+  {   0,   0, 196, 196, 212, 212, 213, 213, 199, 199,   0,   0, },  // 153: 6 0 3
+  {   0,   0, 196, 196, 212, 212, 214, 214, 203, 203,   0,   0, },  // 154: 6 1 3
+  {   0,   0, 196, 196, 212, 212, 215, 215, 209, 209,   0,   0, },  // 155: 6 2 3
+  {   0,   0, 196, 196, 212, 212, 215, 215, 209, 209,   0,   0, },  // 156: 6 3 3
+  {   0,   0, 196, 196, 197, 197, 210, 210, 209, 209,   0,   0, },  // 157: 6 3 0
+  {   0,   0, 196, 196, 200, 200, 211, 211, 209, 209,   0,   0, },  // 158: 6 3 1
+  {   0,   0, 196, 196, 205, 205, 208, 208, 209, 209,   0,   0, },  // 159: 6 3 2
+  {   0,   0, 196, 196, 216, 216, 217, 217, 199, 199,   0,   0, },  // 160: 6 0 4
+  {   0,   0, 196, 196, 216, 216, 218, 218, 203, 203,   0,   0, },  // 161: 6 1 4
+  {   0,   0, 196, 196, 216, 216, 219, 219, 209, 209,   0,   0, },  // 162: 6 2 4
+  {   0,   0, 196, 196, 216, 216, 219, 219, 209, 209,   0,   0, },  // 163: 6 3 4
+  {   0,   0, 196, 196, 220, 220, 221, 221, 199, 199,   0,   0, },  // 164: 6 0 5
+  {   0,   0, 196, 196, 220, 220, 222, 222, 203, 203,   0,   0, },  // 165: 6 1 5
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 166: 6 2 5
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 167: 6 3 5
+  {   0,   0,   0,   1, 168, 169, 170, 171,   6,   7,   0,   0, },  // 168: 0 0 6
+  {   0,   0,   8,   8, 172, 172, 173, 173,  11,  11,   0,   0, },  // 169: 1 0 6
+  {   0,   0,   0,   1, 168, 169, 174, 175,  20,  21,   0,   0, },  // 170: 0 1 6
+  {   0,   0,   8,   8, 172, 172, 176, 176,  23,  23,   0,   0, },  // 171: 1 1 6
+  {   0,   0,  27,  27, 177, 177, 178, 178,  30,  30,   0,   0, },  // 172: 2 0 6
+  {   0,   0,  27,  27, 177, 177, 179, 179,  34,  34,   0,   0, },  // 173: 2 1 6
+  {   0,   0,   0,   1, 168, 169, 180, 181,  50,  51,   0,   0, },  // 174: 0 2 6
+  {   0,   0,   8,   8, 172, 172, 182, 182,  53,  53,   0,   0, },  // 175: 1 2 6
+  {   0,   0,  27,  27, 177, 177, 183, 183,  58,  58,   0,   0, },  // 176: 2 2 6
+  {   0,   0,  64,  64, 184, 184, 185, 185,  67,  67,   0,   0, },  // 177: 3 0 6
+  {   0,   0,  64,  64, 184, 184, 186, 186,  71,  71,   0,   0, },  // 178: 3 1 6
+  {   0,   0,  64,  64, 184, 184, 187, 187,  77,  77,   0,   0, },  // 179: 3 2 6
+  {   0,   0,   0,   1, 168, 169, 180, 181,  50,  51,   0,   0, },  // 180: 0 3 6
+  {   0,   0,   8,   8, 172, 172, 182, 182,  53,  53,   0,   0, },  // 181: 1 3 6
+  {   0,   0,  27,  27, 177, 177, 183, 183,  58,  58,   0,   0, },  // 182: 2 3 6
+  {   0,   0,  64,  64, 184, 184, 187, 187,  77,  77,   0,   0, },  // 183: 3 3 6
+  {   0,   0, 100, 100, 188, 188, 189, 189, 103, 103,   0,   0, },  // 184: 4 0 6
+  {   0,   0, 100, 100, 188, 188, 190, 190, 107, 107,   0,   0, },  // 185: 4 1 6
+  {   0,   0, 100, 100, 188, 188, 191, 191, 113, 113,   0,   0, },  // 186: 4 2 6
+  {   0,   0, 100, 100, 188, 188, 191, 191, 113, 113,   0,   0, },  // 187: 4 3 6
+  {   0,   0, 144, 144, 192, 192, 193, 193, 147, 147,   0,   0, },  // 188: 5 0 6
+  {   0,   0, 144, 144, 192, 192, 194, 194, 151, 151,   0,   0, },  // 189: 5 1 6
+  {   0,   0, 144, 144, 192, 192, 195, 195, 157, 157,   0,   0, },  // 190: 5 2 6
+  {   0,   0, 144, 144, 192, 192, 195, 195, 157, 157,   0,   0, },  // 191: 5 3 6
+  {   0,   0, 196, 196, 220, 220, 221, 221, 199, 199,   0,   0, },  // 192: 6 0 6
+  {   0,   0, 196, 196, 220, 220, 222, 222, 203, 203,   0,   0, },  // 193: 6 1 6
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 194: 6 2 6
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 195: 6 3 6
+  {   0,   0, 196, 196, 197, 197, 198, 198, 199, 199,   0,   0, },  // 196: 7 0 0
+  {   0,   0, 196, 196, 200, 200, 201, 201, 199, 199,   0,   0, },  // 197: 7 0 1
+  {   0,   0, 196, 196, 200, 200, 202, 202, 203, 203,   0,   0, },  // 198: 7 1 1
+  {   0,   0, 196, 196, 197, 197, 204, 204, 203, 203,   0,   0, },  // 199: 7 1 0
+  {   0,   0, 196, 196, 205, 205, 206, 206, 199, 199,   0,   0, },  // 200: 7 0 2
+  {   0,   0, 196, 196, 205, 205, 207, 207, 203, 203,   0,   0, },  // 201: 7 1 2
+  {   0,   0, 196, 196, 205, 205, 208, 208, 209, 209,   0,   0, },  // 202: 7 2 2
+  {   0,   0, 196, 196, 197, 197, 210, 210, 209, 209,   0,   0, },  // 203: 7 2 0
+  {   0,   0, 196, 196, 200, 200, 211, 211, 209, 209,   0,   0, },  // 204: 7 2 1
+  {   0,   0, 196, 196, 212, 212, 213, 213, 199, 199,   0,   0, },  // 205: 7 0 3
+  {   0,   0, 196, 196, 212, 212, 214, 214, 203, 203,   0,   0, },  // 206: 7 1 3
+  {   0,   0, 196, 196, 212, 212, 215, 215, 209, 209,   0,   0, },  // 207: 7 2 3
+  {   0,   0, 196, 196, 212, 212, 215, 215, 209, 209,   0,   0, },  // 208: 7 3 3
+  {   0,   0, 196, 196, 197, 197, 210, 210, 209, 209,   0,   0, },  // 209: 7 3 0
+  {   0,   0, 196, 196, 200, 200, 211, 211, 209, 209,   0,   0, },  // 210: 7 3 1
+  {   0,   0, 196, 196, 205, 205, 208, 208, 209, 209,   0,   0, },  // 211: 7 3 2
+  {   0,   0, 196, 196, 216, 216, 217, 217, 199, 199,   0,   0, },  // 212: 7 0 4
+  {   0,   0, 196, 196, 216, 216, 218, 218, 203, 203,   0,   0, },  // 213: 7 1 4
+  {   0,   0, 196, 196, 216, 216, 219, 219, 209, 209,   0,   0, },  // 214: 7 2 4
+  {   0,   0, 196, 196, 216, 216, 219, 219, 209, 209,   0,   0, },  // 215: 7 3 4
+  {   0,   0, 196, 196, 220, 220, 221, 221, 199, 199,   0,   0, },  // 216: 7 0 5
+  {   0,   0, 196, 196, 220, 220, 222, 222, 203, 203,   0,   0, },  // 217: 7 1 5
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 218: 7 2 5
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 219: 7 3 5
+  {   0,   0, 196, 196, 220, 220, 221, 221, 199, 199,   0,   0, },  // 220: 7 0 6
+  {   0,   0, 196, 196, 220, 220, 222, 222, 203, 203,   0,   0, },  // 221: 7 1 6
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 222: 7 2 6
+  {   0,   0, 196, 196, 220, 220, 223, 223, 209, 209,   0,   0, },  // 223: 7 3 6
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*
+* Compressed record of the last few pulse trains
+*
+* When a frame fails its check there's otherwise no way to tell what the
+* radio actually produced.  PulseCapture keeps the most recent pulse trains
+* in a CAPTURE_SIZE byte ring, one byte per pulse or less:
+*
+*   0x00-0x7F  pulse of this many CAPTURE_UNIT us (longer ones are clipped)
+*   0x81-0xFD  the previous width again, 1 to 125 more times
+*   0xFE/0xFF  a new train starts, its first pulse is low/high
+*
+* Levels alternate within a train, a lost edge starts a new train.  Pulses
+* within CAPTURE_TOL units of the width a run started with count as a repeat,
+* so the long runs of sync and short pulses take a byte or two.  The oldest
+* trains are overwritten as new ones come in, until freeze() keeps what's
+* there for dumping.  host/ookcapture.cpp turns a dump back into pulse data
+* that ookreplay can run.
+*/
+
+#ifndef PULSE_CAPTURE_H
+#define PULSE_CAPTURE_H
+
+#define CAPTURE_SIZE   256  // bytes, several frames
+#define CAPTURE_UNIT   16   // us per width step
+#define CAPTURE_TOL    1    // width steps a repeat may be off by
+#define CAPTURE_WIDTH  0x7F
+#define CAPTURE_RUN    0x80
+#define CAPTURE_LOW    0xFE
+#define CAPTURE_HIGH   0xFF
+
+class PulseCapture {
+protected:
+    byte buf[CAPTURE_SIZE];
+    word head;      // next byte written
+    word count;     // bytes held
+    byte last;      // width code the current run started with
+    bool inTrain;
+    bool inRun;     // the newest byte is a run byte that can still grow
+    byte nextHigh;  // level the next pulse of the train should have
+    bool frozen;
+
+    void put (byte b) {
+        buf[head] = b;
+        head = (head + 1) % CAPTURE_SIZE;
+        if (count < CAPTURE_SIZE)
+            count++;
+    }
+
+    byte& newest (void) {
+        return buf[(head + CAPTURE_SIZE - 1) % CAPTURE_SIZE];
+    }
+
+public:
+    word freezes;   // checksum failures that froze the capture
+
+    PulseCapture () : freezes(0) { clear(); }
+
+    void clear (void) {
+        head = count = 0;
+        inTrain = inRun = frozen = false;
+    }
+
+    void pulse (word width, byte high) {
+        if (frozen)
+            return;
+        if (!inTrain || high != nextHigh) {
+            put(high ? CAPTURE_HIGH : CAPTURE_LOW);
+            inTrain = true;
+            inRun = false;
+            last = CAPTURE_RUN;  // no width yet
+        }
+        nextHigh = !high;
+
+        word code = width / CAPTURE_UNIT;
+        if (code > CAPTURE_WIDTH)
+            code = CAPTURE_WIDTH;
+        if (last != CAPTURE_RUN && code + CAPTURE_TOL >= last && code <= last + CAPTURE_TOL) {
+            if (inRun && newest() < CAPTURE_LOW - 1) {
+                newest()++;
+            } else {
+                put(CAPTURE_RUN + 1);
+                inRun = true;
+            }
+            return;
+        }
+        put(code);
+        last = code;
+        inRun = false;
+    }
+
+    // the line went quiet, the next pulse starts a new train
+    void gap (void) {
+        inTrain = false;
+    }
+
+    // keep what's there until resume()
+    void freeze (void) {
+        if (!frozen)
+            freezes++;
+        frozen = true;
+    }
+
+    void resume (void) {
+        frozen = false;
+        inTrain = false;
+    }
+
+    bool isFrozen () const { return frozen; }
+
+    // bytes held, at(0) is the oldest
+    word held () const { return count; }
+
+    byte at (word i) const {
+        return buf[(head + CAPTURE_SIZE - count + i) % CAPTURE_SIZE];
+    }
+
+    // where the oldest whole train starts, once the ring has wrapped the
+    // train before it is cut short
+    word oldest (void) const {
+        word i = 0;
+        while (i < count && at(i) < CAPTURE_LOW)
+            ++i;
+        return i;
+    }
+};
+
+#endif
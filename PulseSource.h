@@ -0,0 +1,162 @@
+/*
+* Pulse acquisition
+*
+* The decode loop pulls batches of pulses from a PulseSource rather than
+* reading the receiver pin itself, so the same decoders can be fed from the
+* pin-change interrupt, the Timer1 input capture unit or, on a host, from a
+* recorded trace (see host/StreamPulseSource.h).
+*
+* A pulse is the time the line spent at one level between two edges.  Widths
+* are kept to a word, the decoders take nothing longer, and a pulse past 65 ms
+* is silence whatever its exact length.  That is 2 bytes less per queued
+* pulse in the board's SRAM.
+*/
+
+#ifndef PULSE_SOURCE_H
+#define PULSE_SOURCE_H
+
+#define PULSE_QUEUE  32  // pulses buffered between interrupt and loop(), power of 2
+
+struct Pulse {
+    unsigned long time;   // micros() at the edge ending the pulse
+    word width;           // duration in us, 0xFFFF for anything longer
+    byte high;            // line level during the pulse, 1 = carrier on
+};
+
+class PulseSource {
+public:
+    virtual void begin () {}
+
+    // copy up to max pending pulses into buf, returns the number copied
+    virtual byte read (Pulse* buf, byte max) =0;
+
+    // true when no edge has been seen for at least us microseconds
+    virtual bool silent (unsigned long us) =0;
+};
+
+#ifdef __AVR__
+#include <util/atomic.h>
+
+// Pulses timed in interrupt context and queued for loop(), so a slow pass
+// through loop() no longer overwrites pulses it hasn't looked at yet.
+class IsrPulseSource : public PulseSource {
+protected:
+    Pulse queue[PULSE_QUEUE];
+    volatile byte head, tail;
+    volatile unsigned long last;  // micros() of the last edge
+
+    // called from the ISR
+    void push (unsigned long now, unsigned long width, byte high) {
+        byte next = (head + 1) & (PULSE_QUEUE - 1);
+        if (next != tail) {
+            Pulse& p = queue[head];
+            p.time = now;
+            p.width = width > 0xFFFF ? 0xFFFF : width;
+            p.high = high;
+            head = next;
+        } else {
+            overruns++;
+        }
+        last = now;
+    }
+
+public:
+    volatile word overruns;  // pulses lost because loop() fell behind
+
+    IsrPulseSource () : head(0), tail(0), last(0), overruns(0) {}
+
+    virtual byte read (Pulse* buf, byte max) {
+        byte n = 0;
+        while (n < max && tail != head) {
+            ATOMIC_BLOCK(ATOMIC_FORCEON)
+            {
+                buf[n++] = queue[tail];
+                tail = (tail + 1) & (PULSE_QUEUE - 1);
+            }
+        }
+        return n;
+    }
+
+    virtual bool silent (unsigned long us) {
+        unsigned long t;
+        ATOMIC_BLOCK(ATOMIC_FORCEON)
+        {
+            t = last;
+        }
+        return micros() - t >= us;
+    }
+};
+
+// Pin-change interrupt on any digital pin.  Resolution is that of micros()
+// (4 us on a 16 MHz UNO) plus interrupt entry jitter.  The sketch routes the
+// PCINT vector for the pin to change().
+class PinChangeSource : public IsrPulseSource {
+protected:
+    byte pin;
+    volatile uint8_t* port;
+    uint8_t mask;
+
+public:
+    PinChangeSource (byte rxPin) : pin(rxPin) {}
+
+    virtual void begin () {
+        pinMode(pin, INPUT);
+        port = portInputRegister(digitalPinToPort(pin));
+        mask = digitalPinToBitMask(pin);
+        last = micros();
+        *digitalPinToPCMSK(pin) |= bit(digitalPinToPCMSKbit(pin));
+        *digitalPinToPCICR(pin) |= bit(digitalPinToPCICRbit(pin));
+    }
+
+    void change (void) {
+        unsigned long now = micros();
+        // the line has just changed, so the pulse that ended had the other level
+        push(now, now - last, (*port & mask) == 0);
+    }
+};
+
+// Timer1 input capture on ICP1 (digital pin 8 on an UNO).  The edge is
+// latched by hardware at 0.5 us resolution, so interrupt latency no longer
+// shows up in the width.  Timer1 is taken over entirely.  The sketch routes
+// TIMER1_CAPT_vect to capture().
+#define ICP_PIN  8
+
+class InputCaptureSource : public IsrPulseSource {
+protected:
+    word lastCapture;
+
+public:
+    virtual void begin () {
+        pinMode(ICP_PIN, INPUT);
+        ATOMIC_BLOCK(ATOMIC_FORCEON)
+        {
+            TCCR1A = 0;
+            // noise canceler, first edge rising, clk/8 = 0.5 us per tick at 16 MHz
+            TCCR1B = bit(ICNC1) | bit(ICES1) | bit(CS11);
+            TIFR1 = bit(ICF1);
+            TIMSK1 = bit(ICIE1);
+            last = micros();
+            lastCapture = TCNT1;
+        }
+    }
+
+    void capture (void) {
+        word stamp = ICR1;
+        unsigned long now = micros();
+        // a rising edge ends a low pulse, then wait for the opposite edge
+        byte high = !(TCCR1B & bit(ICES1));
+        TCCR1B ^= bit(ICES1);
+        TIFR1 = bit(ICF1);
+
+        // timer ticks are exact but wrap every 32 ms, longer pulses are
+        // silence anyway and micros() is good enough for them
+        unsigned long width = now - last;
+        if (width < 30000)
+            width = (word)(stamp - lastCapture) >> 1;
+        lastCapture = stamp;
+        push(now, width, high);
+    }
+};
+#endif
+
+#endif
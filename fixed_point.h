@@ -0,0 +1,68 @@
+/*
+* Integer fixed-point helpers for sensor values.
+*
+* Every quantity is carried as a scaled integer and the scale is part of the
+* name: tempf_x10 is tenths of a degree F, rainfall_x100 hundredths of an inch,
+* windspeed_x100 hundredths of a m/s (cm/s).  This keeps the soft-float library
+* out of both the decode path and the report formatting on AVR.
+*/
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+// m/s to mph is 3.6 * 0.62137 = 2.236932
+#define MS_MPH_NUM   22369L
+#define MS_MPH_DEN   100000L
+
+// scaled divide, rounding half away from zero
+static inline long fxdiv (long num, long den) {
+  if ((num < 0) != (den < 0))
+    return (num - den / 2) / den;
+  return (num + den / 2) / den;
+}
+
+// hundredths of a m/s to tenths of a mph
+static inline long convMsMph_x10 (long ms_x100) {
+  return fxdiv(ms_x100 * MS_MPH_NUM, MS_MPH_DEN);
+}
+
+// hundredths of a m/s to hundredths of a kph
+static inline long convMsKph_x100 (long ms_x100) {
+  return fxdiv(ms_x100 * 36, 10);
+}
+
+// tenths of a degree F to tenths of a degree C
+static inline int convFC_x10 (int f_x10) {
+  return fxdiv((long)(f_x10 - 320) * 5, 9);
+}
+
+// hundredths of an inch to tenths of a mm
+static inline long convInMm_x10 (long in_x100) {
+  return fxdiv(in_x100 * 254, 100);
+}
+
+// longest fxtostrf() number with its terminator: sign, every digit of a
+// long and the decimal point.  Callers size their buffers with it.
+#define FX_STR_SIZE  (sizeof(long) * 3 + 3)
+
+// Format a value scaled by 10^prec the way dtostrf() would format the
+// equivalent float: right aligned in width characters, prec decimals (at
+// most 9).  At most size bytes go to s, terminator included.
+static inline char* fxtostrf (long val, signed char width, byte prec, char* s, size_t size) {
+  char digits[FX_STR_SIZE];
+  unsigned long mag = val < 0 ? -(unsigned long)val : val;
+  unsigned long scale = 1;
+  if (prec > 9)
+    prec = 9;
+  for (byte i = 0; i < prec; ++i)
+    scale *= 10;
+
+  if (prec > 0)
+    snprintf(digits, sizeof digits, "%s%lu.%0*lu", val < 0 ? "-" : "", mag / scale, prec, mag % scale);
+  else
+    snprintf(digits, sizeof digits, "%s%lu", val < 0 ? "-" : "", mag);
+  snprintf(s, size, "%*s", width, digits);
+  return s;
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+* Minimal Arduino core for building the decoders on a host.
+*
+* Only what the decoders and the shared receiver loop use is provided.
+* Serial goes to stdout, pin I/O does nothing and millis()/micros() count
+* from program start.
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+
+#define DEC     10
+#define HEX     16
+
+#define PROGMEM
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+
+class __FlashStringHelper;
+#define F(s)  (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#define bit(b)  (1UL << (b))
+
+static inline unsigned long micros (void) {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static inline unsigned long millis (void) {
+    return micros() / 1000;
+}
+
+static inline void pinMode (uint8_t, uint8_t) {}
+static inline void digitalWrite (uint8_t, uint8_t) {}
+static inline void noInterrupts (void) {}
+static inline void interrupts (void) {}
+
+class Print {
+public:
+    virtual ~Print () {}
+    virtual size_t write (uint8_t c) =0;
+
+    virtual size_t write (const uint8_t* buf, size_t size) {
+        size_t n = 0;
+        while (size--)
+            n += write(*buf++);
+        return n;
+    }
+
+    size_t print (const char* s)                { return write((const uint8_t*)s, strlen(s)); }
+    size_t print (const __FlashStringHelper* s) { return print(reinterpret_cast<const char*>(s)); }
+    size_t print (char c)                       { return write((uint8_t)c); }
+    size_t print (unsigned char n, int base =DEC) { return print((unsigned long)n, base); }
+    size_t print (int n, int base =DEC)           { return print((long)n, base); }
+    size_t print (unsigned int n, int base =DEC)  { return print((unsigned long)n, base); }
+
+    size_t print (long n, int base =DEC) {
+        if (base == HEX)
+            return print((unsigned long)n, base);
+        char buf[24];
+        snprintf(buf, sizeof buf, "%ld", n);
+        return print(buf);
+    }
+
+    size_t print (unsigned long n, int base =DEC) {
+        char buf[24];
+        snprintf(buf, sizeof buf, base == HEX ? "%lX" : "%lu", n);
+        return print(buf);
+    }
+
+    size_t println (void) { return print("\r\n"); }
+
+    template <typename T>
+    size_t println (T value) { size_t n = print(value); return n + println(); }
+
+    template <typename T>
+    size_t println (T value, int base) { size_t n = print(value, base); return n + println(); }
+};
+
+class HostSerial : public Print {
+public:
+    void begin (unsigned long) {}
+    int availableForWrite (void) { return 64; }
+    virtual size_t write (uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+static HostSerial Serial;
+
+#endif
@@ -0,0 +1,72 @@
+/*
+* Fixed capacity blocking queue linking the daemon's threads.
+*
+* Producers block while the queue is full, so a slow stage pushes back on the
+* one feeding it instead of growing memory.  Consumers block until an item
+* arrives, a deadline passes or the queue is closed.  Nothing spins.
+*/
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+template <typename T>
+class BoundedQueue {
+protected:
+    std::mutex lock;
+    std::condition_variable notEmpty, notFull;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    BoundedQueue (size_t size) : capacity(size), closed(false) {}
+
+    // false once the queue has been closed
+    bool push (const T& item) {
+        std::unique_lock<std::mutex> guard(lock);
+        notFull.wait(guard, [this] { return closed || items.size() < capacity; });
+        if (closed)
+            return false;
+        items.push_back(item);
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // false when the deadline passed or the queue is closed and drained
+    bool pop (T& item, Clock::time_point deadline = Clock::time_point::max()) {
+        std::unique_lock<std::mutex> guard(lock);
+        auto ready = [this] { return closed || !items.empty(); };
+        if (deadline == Clock::time_point::max())
+            notEmpty.wait(guard, ready);
+        else if (!notEmpty.wait_until(guard, deadline, ready))
+            return false;
+        if (items.empty())
+            return false;
+        item = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // wake everybody up, pushes fail from now on and pops drain what's left
+    void close (void) {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    bool isClosed (void) {
+        std::lock_guard<std::mutex> guard(lock);
+        return closed && items.empty();
+    }
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+* EEPROM for host builds.
+*
+* Same read()/write()/update() interface as the Arduino EEPROM library over
+* E2END+1 bytes that start out erased (0xFF).  open() backs it with a file
+* so state survives a restart the way it does on the board, every write goes
+* straight through to the file.
+*/
+
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <Arduino.h>
+
+#define E2END  0x3FF  // same size as the ATmega328P
+
+class EEPROMClass {
+protected:
+    uint8_t mem[E2END + 1];
+    FILE* file;
+
+public:
+    EEPROMClass () : file(0) { memset(mem, 0xFF, sizeof mem); }
+
+    ~EEPROMClass () {
+        if (file)
+            fclose(file);
+    }
+
+    // load the contents from path, creating it if it doesn't exist yet
+    bool open (const char* path) {
+        file = fopen(path, "r+b");
+        if (file) {
+            size_t n = fread(mem, 1, sizeof mem, file);
+            (void)n;  // a short file is erased beyond its end
+            return true;
+        }
+        file = fopen(path, "w+b");
+        return file && fwrite(mem, 1, sizeof mem, file) == sizeof mem && fflush(file) == 0;
+    }
+
+    uint8_t read (int addr) { return mem[addr]; }
+
+    void write (int addr, uint8_t value) {
+        mem[addr] = value;
+        if (file) {
+            fseek(file, addr, SEEK_SET);
+            fputc(value, file);
+            fflush(file);
+        }
+    }
+
+    void update (int addr, uint8_t value) {
+        if (mem[addr] != value)
+            write(addr, value);
+    }
+
+    uint16_t length (void) { return E2END + 1; }
+};
+
+static EEPROMClass EEPROM;
+
+#endif
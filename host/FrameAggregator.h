@@ -0,0 +1,107 @@
+/*
+* Cross-receiver deduplication of decoded frames.
+*
+* With several receivers around a property the same transmission is often
+* decoded two or three times.  Frames are keyed on protocol plus the raw
+* payload (which carries the sensor ID) in a hash table whose entries live for
+* one window.  The first copy opens the window, later copies only replace it
+* when they were heard with a better RSSI, and the winner is emitted once when
+* the window closes.  The key is then held for one more window so stragglers
+* from slow receivers are dropped instead of emitted a second time.
+*/
+
+#ifndef FRAME_AGGREGATOR_H
+#define FRAME_AGGREGATOR_H
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "../OokReceiver.h"
+
+struct ReceivedFrame {
+    Frame frame;
+    int receiver;  // index of the input that decoded it
+    int rssi;      // dB, higher is better
+    std::chrono::steady_clock::time_point arrival;
+};
+
+class FrameAggregator {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+protected:
+    struct Entry {
+        ReceivedFrame best;
+        bool emitted;
+    };
+
+    typedef std::pair<std::string, Clock::time_point> Expiry;
+
+    Clock::duration window;
+    std::unordered_map<std::string, Entry> table;
+    std::deque<Expiry> expiry;  // in deadline order since the window is fixed
+
+    static std::string key (const Frame& f) {
+        std::string k(1, (char)f.protocol);
+        k.append((const char*)f.data, f.len);
+        return k;
+    }
+
+    // best RSSI wins, the earliest arrival breaks ties
+    static bool better (const ReceivedFrame& a, const ReceivedFrame& b) {
+        if (a.rssi != b.rssi)
+            return a.rssi > b.rssi;
+        return a.arrival < b.arrival;
+    }
+
+public:
+    unsigned long unique;      // frames emitted
+    unsigned long duplicates;  // copies folded into an earlier one
+
+    FrameAggregator (Clock::duration dedupWindow)
+        : window(dedupWindow), unique(0), duplicates(0) {}
+
+    void add (const ReceivedFrame& r) {
+        std::string k = key(r.frame);
+        auto it = table.find(k);
+        if (it == table.end()) {
+            table.emplace(k, Entry{r, false});
+            expiry.push_back(Expiry(k, r.arrival + window));
+            return;
+        }
+        duplicates++;
+        Entry& e = it->second;
+        if (!e.emitted && better(r, e.best))
+            e.best = r;
+    }
+
+    // emit every frame whose window has closed by now, returns when the
+    // next window closes so the caller knows how long it may sleep
+    template <typename Emit>
+    Clock::time_point flush (Clock::time_point now, Emit emit) {
+        while (!expiry.empty() && expiry.front().second <= now) {
+            Expiry next = expiry.front();
+            expiry.pop_front();
+            auto it = table.find(next.first);
+            if (it->second.emitted) {
+                table.erase(it);
+            } else {
+                unique++;
+                emit(it->second.best);
+                it->second.emitted = true;
+                expiry.push_back(Expiry(next.first, next.second + window));
+            }
+        }
+        return expiry.empty() ? Clock::time_point::max() : expiry.front().second;
+    }
+
+    // emit everything still pending, e.g. when the inputs are gone
+    template <typename Emit>
+    void drain (Emit emit) {
+        flush(Clock::time_point::max() - window, emit);
+    }
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*
+* Bounded lock-free multi-producer single-consumer queue.
+*
+* Producers claim a cell with one compare-and-swap on the head index and
+* publish it through the cell's sequence number (Vyukov's bounded queue), so
+* receivers never contend on a lock to hand over a frame.  The single
+* consumer reads without atomics on its own tail.  When the queue runs dry the
+* consumer may sleep in wait(); producers only touch the mutex to wake it if it
+* actually is asleep.  The other way round, a producer that finds the queue
+* full sleeps in push() until pop() frees a cell, and pop() only touches the
+* mutex when a producer is blocked.  Once the producers are done one of them
+* closes the queue, which wait() checks under its mutex so the consumer can't
+* miss it and sleep to its deadline.
+*/
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T, size_t N>
+class MpscQueue {
+protected:
+    static_assert((N & (N - 1)) == 0, "queue size must be a power of 2");
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        T item;
+    };
+
+    Cell cells[N];
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) size_t tail;
+    std::atomic<bool> sleeping;
+    bool closed;  // under lock
+    std::atomic<int> blocked;  // producers waiting for room
+    std::mutex lock, roomLock;
+    std::condition_variable wake, room;
+
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    MpscQueue () : head(0), tail(0), sleeping(false), closed(false), blocked(0) {
+        for (size_t i = 0; i < N; ++i)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // false when the queue is full
+    bool tryPush (const T& item) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & (N - 1)];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item = item;
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> guard(lock);
+            wake.notify_one();
+        }
+        return true;
+    }
+
+    // a full queue means the consumer is behind, sleep until it pops
+    void push (const T& item) {
+        if (tryPush(item))
+            return;
+        std::unique_lock<std::mutex> guard(roomLock);
+        blocked.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!tryPush(item))
+            room.wait(guard);
+        blocked.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // consumer only
+    bool pop (T& item) {
+        Cell& cell = cells[tail & (N - 1)];
+        if (cell.seq.load(std::memory_order_acquire) != tail + 1)
+            return false;
+        item = cell.item;
+        cell.seq.store(tail + N, std::memory_order_release);
+        ++tail;
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blocked.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> guard(roomLock);
+            room.notify_all();
+        }
+        return true;
+    }
+
+    // consumer only, sleep until something is pushed, the queue is closed or
+    // the deadline passes
+    void wait (Clock::time_point deadline) {
+        std::unique_lock<std::mutex> guard(lock);
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto ready = [this] {
+            return closed || cells[tail & (N - 1)].seq.load(std::memory_order_acquire) == tail + 1;
+        };
+        if (deadline == Clock::time_point::max())
+            wake.wait(guard, ready);
+        else
+            wake.wait_until(guard, deadline, ready);
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    // no more pushes, wake the consumer for good
+    void close (void) {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        wake.notify_one();
+    }
+
+    // true once closed, everything pushed before is there to pop then
+    bool isClosed (void) {
+        std::lock_guard<std::mutex> guard(lock);
+        return closed;
+    }
+};
+
+#endif
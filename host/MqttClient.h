@@ -0,0 +1,122 @@
+/*
+* Just enough MQTT 3.1.1 to publish reports at QoS 0: CONNECT, PUBLISH and
+* DISCONNECT over a plain TCP socket.  The keep alive is disabled since the
+* daemon only ever talks and reconnects on the first failed write.
+*/
+
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <netdb.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+
+class MqttClient {
+protected:
+    std::string host, port, clientId;
+    int sock;
+
+    static void putString (std::string& out, const char* s) {
+        size_t len = strlen(s);
+        out += (char)(len >> 8);
+        out += (char)(len & 0xFF);
+        out += s;
+    }
+
+    static void putLength (std::string& out, size_t len) {
+        do {
+            char b = len & 0x7F;
+            len >>= 7;
+            if (len > 0)
+                b |= 0x80;
+            out += b;
+        } while (len > 0);
+    }
+
+    bool send (unsigned char type, const std::string& body) {
+        std::string packet(1, (char)type);
+        putLength(packet, body.size());
+        packet += body;
+        const char* p = packet.data();
+        size_t left = packet.size();
+        while (left > 0) {
+            ssize_t n = ::send(sock, p, left, MSG_NOSIGNAL);
+            if (n <= 0) {
+                close();
+                return false;
+            }
+            p += n;
+            left -= n;
+        }
+        return true;
+    }
+
+public:
+    MqttClient (const char* brokerHost, int brokerPort, const char* id)
+        : host(brokerHost), port(std::to_string(brokerPort)), clientId(id), sock(-1) {}
+
+    ~MqttClient () { disconnect(); }
+
+    bool connected (void) const { return sock >= 0; }
+
+    bool connect (void) {
+        if (connected())
+            return true;
+
+        struct addrinfo hints, *res;
+        memset(&hints, 0, sizeof hints);
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0)
+            return false;
+        for (struct addrinfo* ai = res; ai && sock < 0; ai = ai->ai_next) {
+            sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (sock >= 0 && ::connect(sock, ai->ai_addr, ai->ai_addrlen) != 0)
+                close();
+        }
+        freeaddrinfo(res);
+        if (sock < 0)
+            return false;
+
+        std::string body;
+        putString(body, "MQTT");
+        body += (char)4;     // protocol level 3.1.1
+        body += (char)0x02;  // clean session
+        body += (char)0;     // keep alive disabled
+        body += (char)0;
+        putString(body, clientId.c_str());
+        if (!send(0x10, body))
+            return false;
+
+        unsigned char ack[4];
+        if (recv(sock, ack, sizeof ack, MSG_WAITALL) != sizeof ack || ack[0] != 0x20 || ack[3] != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool publish (const char* topic, const char* payload) {
+        if (!connect())
+            return false;
+        std::string body;
+        putString(body, topic);
+        body += payload;
+        return send(0x30, body);
+    }
+
+    void disconnect (void) {
+        if (connected())
+            send(0xE0, std::string());
+        close();
+    }
+
+    void close (void) {
+        if (sock >= 0)
+            ::close(sock);
+        sock = -1;
+    }
+};
+
+#endif
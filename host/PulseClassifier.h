@@ -0,0 +1,171 @@
+/*
+* Batch preamble classification for the host decode path.
+*
+* Every pulse the receiver sees is first put in a width bucket and turned
+* into a preamble symbol (PreambleMatcher::symbol), one compare per bucket
+* bound.  When reprocessing captures that is most of the work, so on the host
+* a whole batch of widths is classified at once, 16 (SSE2) or 32 (AVX2) lanes
+* at a time, and the receiver steps the automaton with the ready symbols.
+* The per protocol windows of the decoders only come into it once their
+* preamble has matched, which is a small part of the pulses.
+*
+* The symbol, class * 2 + level, is built without a table lookup: crossing
+* bound b changes the class by preamble_class[b + 1] - preamble_class[b], so
+* each lane adds that step wherever width >= bound.  The compare is a
+* saturating subtract, bound - width is 0 exactly when width has reached it.
+*
+* The widest kernel the CPU supports is picked at run time, the scalar loop
+* is the fallback and the reference host/ookbench.cpp checks the others
+* against.
+*/
+
+#ifndef PULSE_CLASSIFIER_H
+#define PULSE_CLASSIFIER_H
+
+#include "../PreambleMatcher.h"
+#include "../PulseSource.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CLASSIFY_X86
+#endif
+
+#define CLASSIFY_BATCH  64  // pulses read and classified per poll()
+
+// the bound steps of the symbol, built from the generated tables once
+struct SymbolSteps {
+    word bound[PREAMBLE_BUCKETS - 1];
+    short step[PREAMBLE_BUCKETS - 1];  // symbol change crossing bound, class * 2
+    byte base;                         // symbol of bucket 0 at low level
+
+    SymbolSteps () {
+        base = pgm_read_byte(&preamble_class[0]) * 2;
+        for (byte b = 0; b < PREAMBLE_BUCKETS - 1; ++b) {
+            bound[b] = pgm_read_word(&preamble_bounds[b]);
+            step[b] = (pgm_read_byte(&preamble_class[b + 1]) - pgm_read_byte(&preamble_class[b])) * 2;
+        }
+    }
+};
+
+static const SymbolSteps symbolSteps;
+
+static void classifyScalar (const word* widths, const byte* high, byte* sym, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        sym[i] = PreambleMatcher::symbol(widths[i], high[i]);
+}
+
+#ifdef CLASSIFY_X86
+
+__attribute__((target("sse2")))
+static __m128i symbols8 (__m128i w) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_set1_epi16(symbolSteps.base);
+    for (byte b = 0; b < PREAMBLE_BUCKETS - 1; ++b) {
+        __m128i reached = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_set1_epi16(symbolSteps.bound[b]), w), zero);
+        acc = _mm_add_epi16(acc, _mm_and_si128(reached, _mm_set1_epi16(symbolSteps.step[b])));
+    }
+    return acc;
+}
+
+__attribute__((target("sse2")))
+static void classifySse2 (const word* widths, const byte* high, byte* sym, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i lo = symbols8(_mm_loadu_si128((const __m128i*)(widths + i)));
+        __m128i hi = symbols8(_mm_loadu_si128((const __m128i*)(widths + i + 8)));
+        __m128i s = _mm_add_epi8(_mm_packus_epi16(lo, hi), _mm_loadu_si128((const __m128i*)(high + i)));
+        _mm_storeu_si128((__m128i*)(sym + i), s);
+    }
+    classifyScalar(widths + i, high + i, sym + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static __m256i symbols16 (__m256i w) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = _mm256_set1_epi16(symbolSteps.base);
+    for (byte b = 0; b < PREAMBLE_BUCKETS - 1; ++b) {
+        __m256i reached = _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_set1_epi16(symbolSteps.bound[b]), w), zero);
+        acc = _mm256_add_epi16(acc, _mm256_and_si256(reached, _mm256_set1_epi16(symbolSteps.step[b])));
+    }
+    return acc;
+}
+
+__attribute__((target("avx2")))
+static void classifyAvx2 (const word* widths, const byte* high, byte* sym, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i lo = symbols16(_mm256_loadu_si256((const __m256i*)(widths + i)));
+        __m256i hi = symbols16(_mm256_loadu_si256((const __m256i*)(widths + i + 16)));
+        // the pack works within 128 bit halves, put the quarters back in order
+        __m256i s = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        s = _mm256_add_epi8(s, _mm256_loadu_si256((const __m256i*)(high + i)));
+        _mm256_storeu_si256((__m256i*)(sym + i), s);
+    }
+    classifySse2(widths + i, high + i, sym + i, n - i);
+}
+
+#endif
+
+class PulseClassifier {
+public:
+    enum Kind { SCALAR, SSE2, AVX2 };
+
+    static const byte BATCH = CLASSIFY_BATCH;
+
+protected:
+    Kind kind;
+    void (*kernel)(const word*, const byte*, byte*, size_t);
+
+public:
+    // the widest kind this CPU runs
+    static Kind best (void) {
+#ifdef CLASSIFY_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return AVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return SSE2;
+#endif
+        return SCALAR;
+    }
+
+    static bool supported (Kind k) {
+        return k <= best();
+    }
+
+    PulseClassifier () { select(best()); }
+    PulseClassifier (Kind k) { select(supported(k) ? k : best()); }
+
+    void select (Kind k) {
+        kind = k;
+        kernel = classifyScalar;
+#ifdef CLASSIFY_X86
+        if (k == SSE2)
+            kernel = classifySse2;
+        else if (k == AVX2)
+            kernel = classifyAvx2;
+#endif
+    }
+
+    const char* name (void) const {
+        return kind == AVX2 ? "avx2" : kind == SSE2 ? "sse2" : "scalar";
+    }
+
+    // widths and levels in separate arrays, as the kernels take them
+    void operator() (const word* widths, const byte* high, byte* sym, size_t n) const {
+        kernel(widths, high, sym, n);
+    }
+
+    // a batch of up to BATCH pulses as the sources return them
+    void operator() (const Pulse* pulses, byte* sym, byte n) const {
+        word widths[BATCH];
+        byte high[BATCH];
+        for (byte i = 0; i < n; ++i) {
+            widths[i] = pulses[i].width;
+            high[i] = pulses[i].high ? 1 : 0;
+        }
+        kernel(widths, high, sym, n);
+    }
+};
+
+#endif
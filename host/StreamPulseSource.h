@@ -0,0 +1,109 @@
+/*
+* PulseSource reading rtl_433 style OOK pulse data from a stdio stream.
+*
+* This covers recorded trace files (rtl_433 -w capture.ook), FIFOs and a
+* live "rtl_433 -w OOK:-" pipe on stdin.  The format is
+*
+*   ;pulse data
+*   ;version 1
+*   ;timescale 1us
+*   ;ook 104 pulses
+*   ;rssi -3.2 dB
+*   460 620
+*   ...
+*   ;end
+*
+* where each data line is the width of a high pulse followed by the width of
+* the low gap after it.  Lines starting with ';' are headers.  Consecutive
+* packages are separated by a STREAM_SILENCE long silence since the real gap
+* between them isn't recorded.  A package may carry a
+*
+*   ;gap 30000000
+*
+* header giving the silence in us that follows it instead, so that a trace
+* spanning hours keeps its timing when replayed against a VirtualClock.
+*/
+
+#ifndef STREAM_PULSE_SOURCE_H
+#define STREAM_PULSE_SOURCE_H
+
+#include "../PulseSource.h"
+
+#define STREAM_SILENCE  100000UL  // us of silence inserted between packages
+
+class StreamPulseSource : public PulseSource {
+protected:
+    FILE* in;
+    unsigned long now;        // trace time in us
+    unsigned long timescale;  // us per count
+    unsigned long gap;        // low half of the last line, still to be returned
+    unsigned long silence;    // after the current package
+    bool pendingGap;
+    bool atEof;
+
+    void emit (Pulse& p, unsigned long width, byte high) {
+        now += width;
+        p.time = now;
+        p.width = width > 0xFFFF ? 0xFFFF : width;
+        p.high = high;
+    }
+
+public:
+    int rssi;  // of the current package in dB, from ";rssi" headers
+
+    // trace time starts at startUs, to line up with a clock that doesn't start at 0
+    StreamPulseSource (FILE* stream, unsigned long startUs =0)
+        : in(stream), now(startUs), timescale(1), gap(0), silence(STREAM_SILENCE), pendingGap(false), atEof(false), rssi(0) {}
+
+    bool eof (void) const { return atEof && !pendingGap; }
+
+    unsigned long time (void) const { return now; }
+
+    virtual byte read (Pulse* buf, byte max) {
+        char line[128];
+        byte n = 0;
+
+        while (n < max) {
+            if (pendingGap) {
+                emit(buf[n++], gap, 0);
+                pendingGap = false;
+                continue;
+            }
+            if (atEof || !fgets(line, sizeof line, in)) {
+                atEof = true;
+                break;
+            }
+
+            if (line[0] == ';') {
+                unsigned long scale, us;
+                float level;
+                if (sscanf(line, ";timescale %luus", &scale) == 1)
+                    timescale = scale;
+                else if (sscanf(line, ";rssi %f", &level) == 1)
+                    rssi = (int)level;
+                else if (sscanf(line, ";gap %lu", &us) == 1)
+                    silence = us;
+                else if (strncmp(line, ";end", 4) == 0) {
+                    emit(buf[n++], silence, 0);
+                    silence = STREAM_SILENCE;
+                }
+                continue;
+            }
+
+            unsigned long high, low;
+            if (sscanf(line, "%lu %lu", &high, &low) != 2)
+                continue;
+            emit(buf[n++], high * timescale, 1);
+            gap = low * timescale;
+            pendingGap = gap > 0;
+        }
+        return n;
+    }
+
+    // the trace carries its own silences, so waiting never adds any
+    virtual bool silent (unsigned long) {
+        return eof();
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+/*
+* The part of EthernetUDP that MqttSn.h uses, over a POSIX socket.
+*
+* A packet is collected between beginPacket() and endPacket() and sent as
+* one datagram.  resolve() looks up a host name to the IPv4 address that
+* beginPacket() takes.
+*/
+
+#ifndef UDP_SOCKET_H
+#define UDP_SOCKET_H
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+
+class UdpSocket {
+protected:
+    int sock;
+    struct sockaddr_in to;
+    std::string packet;
+
+public:
+    UdpSocket () : sock(-1) {}
+    ~UdpSocket () { stop(); }
+
+    static bool resolve (const char* host, byte ip[4]) {
+        struct addrinfo hints, *res;
+        memset(&hints, 0, sizeof hints);
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        if (getaddrinfo(host, 0, &hints, &res) != 0)
+            return false;
+        memcpy(ip, &((struct sockaddr_in*)res->ai_addr)->sin_addr, 4);
+        freeaddrinfo(res);
+        return true;
+    }
+
+    // 0 lets the system pick the local port
+    bool begin (word localPort) {
+        stop();
+        sock = socket(AF_INET, SOCK_DGRAM, 0);
+        if (sock < 0)
+            return false;
+        struct sockaddr_in local;
+        memset(&local, 0, sizeof local);
+        local.sin_family = AF_INET;
+        local.sin_port = htons(localPort);
+        if (bind(sock, (struct sockaddr*)&local, sizeof local) != 0) {
+            stop();
+            return false;
+        }
+        return true;
+    }
+
+    void stop (void) {
+        if (sock >= 0)
+            close(sock);
+        sock = -1;
+    }
+
+    int beginPacket (const byte* ip, word port) {
+        memset(&to, 0, sizeof to);
+        to.sin_family = AF_INET;
+        to.sin_port = htons(port);
+        memcpy(&to.sin_addr, ip, 4);
+        packet.clear();
+        return sock >= 0;
+    }
+
+    size_t write (const byte* buf, size_t size) {
+        packet.append((const char*)buf, size);
+        return size;
+    }
+
+    int endPacket (void) {
+        return sock >= 0 && sendto(sock, packet.data(), packet.size(), 0,
+            (struct sockaddr*)&to, sizeof to) == (ssize_t)packet.size();
+    }
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*
+* Throughput of the host decode path, scalar against batch classification.
+*
+*   g++ -O2 -Ihost -o ookbench host/ookbench.cpp
+*   ./ookbench capture.ook
+*
+* Loads the trace into memory, checks every classifier kind the CPU runs
+* against the scalar one over all widths, then times the classifiers alone
+* and the whole receiver (classification, automaton and decoders) over the
+* trace repeated until each run has some millions of pulses.  The frame
+* counts of the receiver runs have to agree.  Results go to stderr, what
+* the decoders print to Serial is thrown away so it doesn't get timed.
+*/
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <vector>
+
+#include "../OokReceiver.h"
+#include "PulseClassifier.h"
+#include "StreamPulseSource.h"
+
+#define BENCH_PULSES  4000000UL  // pulses per timed run
+
+// hands out a loaded trace as often as asked for
+class MemoryPulseSource : public PulseSource {
+protected:
+    const std::vector<Pulse>& pulses;
+    size_t next;
+    size_t left;
+
+public:
+    MemoryPulseSource (const std::vector<Pulse>& p, size_t total)
+        : pulses(p), next(0), left(total) {}
+
+    virtual byte read (Pulse* buf, byte max) {
+        byte n = 0;
+        for (; n < max && left > 0; ++n, --left) {
+            buf[n] = pulses[next];
+            next = (next + 1) % pulses.size();
+        }
+        return n;
+    }
+
+    virtual bool silent (unsigned long) { return left == 0; }
+};
+
+static double seconds (std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+static void countFrame (void* context, const Frame&) {
+    ++*(unsigned long*)context;
+}
+
+// the whole receiver, classify == 0 takes pulse by pulse as on the board
+static void benchReceiver (const char* name, const std::vector<Pulse>& trace,
+        const PulseClassifier* classify) {
+    MemoryPulseSource source(trace, BENCH_PULSES);
+    OokReceiver receiver(13);
+    unsigned long frames = 0;
+    receiver.onFrame(countFrame, &frames);
+
+    auto start = std::chrono::steady_clock::now();
+    while (!source.silent(0)) {
+        if (classify)
+            receiver.poll(source, *classify);
+        else
+            receiver.poll(source);
+    }
+    receiver.gap();
+    double s = seconds(start);
+    fprintf(stderr, "receiver %-7s %7.1f Mpulses/s  %lu frames\n", name, BENCH_PULSES / s / 1e6, frames);
+}
+
+int main (int argc, char** argv) {
+    FILE* in = stdin;
+    if (argc > 1 && !(in = fopen(argv[1], "r"))) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    std::vector<Pulse> trace;
+    StreamPulseSource source(in);
+    Pulse buf[64];
+    byte n;
+    while ((n = source.read(buf, 64)) > 0)
+        trace.insert(trace.end(), buf, buf + n);
+    if (trace.empty()) {
+        fprintf(stderr, "no pulses in the trace\n");
+        return 1;
+    }
+    fprintf(stderr, "%zu pulses in the trace\n", trace.size());
+    if (!freopen("/dev/null", "w", stdout))
+        return 1;
+
+    const PulseClassifier::Kind kinds[] = { PulseClassifier::SCALAR, PulseClassifier::SSE2, PulseClassifier::AVX2 };
+
+    // every width at both levels, with odd lengths to run the tails
+    std::vector<word> allWidths;
+    std::vector<byte> allHigh;
+    for (unsigned long w = 0; w <= 0xFFFF; ++w)
+        for (byte h = 0; h < 2; ++h) {
+            allWidths.push_back(w);
+            allHigh.push_back(h);
+        }
+    std::vector<byte> want(allWidths.size()), got(allWidths.size());
+    PulseClassifier(PulseClassifier::SCALAR)(allWidths.data(), allHigh.data(), want.data(), want.size());
+    for (PulseClassifier::Kind k : kinds) {
+        if (!PulseClassifier::supported(k))
+            continue;
+        PulseClassifier classify(k);
+        for (size_t len = want.size() - 37; len <= want.size(); len += 37) {
+            classify(allWidths.data(), allHigh.data(), got.data(), len);
+            if (memcmp(want.data(), got.data(), len) != 0) {
+                fprintf(stderr, "%s disagrees with the scalar classifier\n", classify.name());
+                return 1;
+            }
+        }
+    }
+
+    // the trace's widths as the kernels take them
+    std::vector<word> widths;
+    std::vector<byte> high;
+    for (const Pulse& p : trace) {
+        widths.push_back(p.width);
+        high.push_back(p.high ? 1 : 0);
+    }
+    std::vector<byte> sym(widths.size());
+    for (PulseClassifier::Kind k : kinds) {
+        if (!PulseClassifier::supported(k))
+            continue;
+        PulseClassifier classify(k);
+        unsigned long done = 0;
+        unsigned check = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (done < BENCH_PULSES * 10) {
+            classify(widths.data(), high.data(), sym.data(), sym.size());
+            check += sym[done % sym.size()];
+            done += sym.size();
+        }
+        double s = seconds(start);
+        fprintf(stderr, "classify %-7s %7.1f Mpulses/s  (%u)\n", classify.name(), done / s / 1e6, check);
+    }
+
+    benchReceiver("pulse", trace, 0);
+    for (PulseClassifier::Kind k : kinds) {
+        if (!PulseClassifier::supported(k))
+            continue;
+        PulseClassifier classify(k);
+        benchReceiver(classify.name(), trace, &classify);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+* Turn a PulseCapture dump back into pulse data for ookreplay.
+*
+*   g++ -O2 -Ihost -o ookcapture host/ookcapture.cpp
+*   mosquitto_sub -t ookDecoder/capture -C 20 | ./ookcapture > failed.ook
+*   ./ookreplay failed.ook
+*
+* Reads the hex messages of one dump from stdin, bare as mosquitto_sub and
+* the serial port print them or prefixed with their topic as ookreplay does,
+* and writes every train as one rtl_433 style package.  Lines that aren't
+* all hex are skipped, so a serial log can be fed in as it is.  Widths
+* come back as the middle of their CAPTURE_UNIT step.
+*/
+
+#include <Arduino.h>
+
+#include <ctype.h>
+#include <vector>
+
+#include "../PulseCapture.h"
+
+static int hexValue (char c) {
+    return isdigit(c) ? c - '0' : tolower(c) - 'a' + 10;
+}
+
+// one train at a time, data lines are a high width then a low one
+static void printTrain (const std::vector<unsigned>& widths, byte firstHigh) {
+    if (widths.empty())
+        return;
+    printf(";ook %zu pulses\n", widths.size());
+    size_t i = 0;
+    if (!firstHigh)
+        printf("0 %u\n", widths[i++]);  // a zero-width high is skipped
+    for (; i < widths.size(); i += 2)
+        printf("%u %u\n", widths[i], i + 1 < widths.size() ? widths[i + 1] : 0);
+    printf(";end\n");
+}
+
+int main (void) {
+    std::vector<byte> bytes;
+    char line[256];
+    while (fgets(line, sizeof line, stdin)) {
+        line[strcspn(line, "\r\n")] = 0;
+        char* p = strrchr(line, ' ');
+        p = p ? p + 1 : line;
+        size_t len = strlen(p);
+        if (len == 0 || len % 2 || strspn(p, "0123456789ABCDEFabcdef") != len)
+            continue;
+        for (; *p; p += 2)
+            bytes.push_back(hexValue(p[0]) << 4 | hexValue(p[1]));
+    }
+
+    printf(";pulse data\n;version 1\n;timescale 1us\n");
+    std::vector<unsigned> widths;
+    byte firstHigh = 1;
+    unsigned last = 0;
+    for (byte b : bytes) {
+        if (b >= CAPTURE_LOW) {
+            printTrain(widths, firstHigh);
+            widths.clear();
+            firstHigh = b == CAPTURE_HIGH;
+        } else if (b > CAPTURE_RUN) {
+            widths.insert(widths.end(), b - CAPTURE_RUN, last);
+        } else {
+            last = b * CAPTURE_UNIT + CAPTURE_UNIT / 2;
+            widths.push_back(last);
+        }
+    }
+    printTrain(widths, firstHigh);
+    return 0;
+}
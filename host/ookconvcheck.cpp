@@ -0,0 +1,162 @@
+/*
+* The integer sensor conversions against the float expressions they replaced.
+*
+*   g++ -O2 -Ihost -o ookconvcheck host/ookconvcheck.cpp
+*   ./ookconvcheck
+*
+* Every raw input of the 5n1 wind speed, temperature, humidity and rainfall,
+* the 592TX temperature and the Blueline power and energy counts goes
+* through the decoders' own conversion and through the old float
+* expression, written here with float constants since double is float on
+* AVR.  The old value is rounded to the decimals it was printed with, or
+* truncated where it was stored in an integer, and the two have to be
+* within one unit of the last digit.  Prints the largest difference seen
+* for each and exits 1 if any is over.
+*/
+
+#define LOG_LEVEL LOG_LEVEL_NONE
+
+#include <Arduino.h>
+
+#include <math.h>
+
+#include "../OokReceiver.h"
+
+static bool ok = true;
+
+// last digit units a value printed with prec decimals comes out as,
+// dtostrf() rounds half away from zero
+static long printed (float value, byte prec) {
+    float scale = 1;
+    for (byte i = 0; i < prec; ++i)
+        scale *= 10;
+    return lroundf(value * scale);
+}
+
+// what a sweep found
+struct Sweep {
+    const char* name;
+    unsigned long inputs;
+    long worst;
+    long worstAt;
+
+    Sweep (const char* n) : name(n), inputs(0), worst(0), worstAt(0) {}
+
+    void compare (long raw, long fixed, long old) {
+        long diff = labs(fixed - old);
+        if (diff > worst) {
+            worst = diff;
+            worstAt = raw;
+        }
+        ++inputs;
+    }
+
+    ~Sweep () {
+        printf("%-22s %6lu inputs, largest difference %ld", name, inputs, worst);
+        if (worst)
+            printf(" (raw %ld)", worstAt);
+        printf("\n");
+        if (worst > 1) {
+            printf("FAIL: %s is off by more than one\n", name);
+            ok = false;
+        }
+    }
+};
+
+// the number a report field holds, e.g. "CurrentPower" in "...,CurrentPower=123,..."
+static long field (const char* report, const char* name) {
+    const char* at = strstr(report, name);
+    return at ? atol(at + strlen(name) + 1) : -1;
+}
+
+static void acurite5n1 (void) {
+    Acurite5n1 station;
+
+    {
+        Sweep s("5n1 wind speed mph");
+        for (word raw = 0; raw < 1024; ++raw) {
+            byte hi = raw >> 3, lo = (raw & 7) << 4;
+            float speed = raw;
+            if (speed > 0)
+                speed = speed * 0.23f + 0.28f;
+            float kph = speed * 60 * 60 / 1000;
+            s.compare(raw, convMsMph_x10(station.getWindSpeed(hi, lo)), printed(kph * 0.62137f, 1));
+        }
+    }
+    {
+        Sweep s("5n1 wind direction");
+        static const float winddirections[16] = { 315.0, 247.5, 292.5, 270.0,
+                                                  337.5, 225.0, 0.0, 202.5,
+                                                  67.5, 135.0, 90.0, 112.5,
+                                                  45.0, 157.5, 22.5, 180.0 };
+        for (byte raw = 0; raw < 16; ++raw)
+            s.compare(raw, station.getWindDirection(raw), printed(winddirections[raw], 1));
+    }
+    {
+        Sweep s("5n1 temperature F");
+        for (word raw = 0; raw < 2048; ++raw) {
+            byte hi = raw >> 7, lo = raw & 0x7F;
+            s.compare(raw, station.getTempF(hi, lo), printed((raw - 400) / 10.0f, 1));
+        }
+    }
+    {
+        Sweep s("5n1 humidity");
+        for (word raw = 0; raw < 256; ++raw)
+            s.compare(raw, station.getHumidity(raw), raw & 0x7F);
+    }
+    {
+        // the rainfall since the first counter seen, for every rise of the
+        // 14 bit counter
+        Sweep s("5n1 rainfall in");
+        for (word raw = 0; raw < 0x4000; ++raw) {
+            unsigned int base = 0, current = station.getRainfallCounter(raw >> 7, raw & 0x7F);
+            unsigned int rainfall_x100 = current - base;
+            s.compare(raw, rainfall_x100, printed((current - base) * 0.01f, 2));
+        }
+    }
+}
+
+static void acurite592tx (void) {
+    Acurite592TX sensor;
+    Sweep s("592TX temperature F");
+    for (word raw = 0; raw < 2048; ++raw) {
+        byte hi = raw >> 7, lo = raw & 0x7F;
+        s.compare(raw, sensor.getTempF(hi, lo), (int)((raw - 1000.0f) / 10.0f * 9.0f / 5.0f + 32.0f));
+    }
+}
+
+static void blueline (void) {
+    Blueline meter;
+    char report[REPORT_SIZE];
+    const float Kh = Kh_x10 / 10.0f;
+
+    {
+        // counts so short the watts don't fit the 16 bit reading overflowed
+        // in the float code too, they start at 3600000 * Kh / 0xFFFF
+        Sweep s("Blueline power W");
+        for (unsigned long count = 4; count <= 0xFFFC; count += 4) {
+            float watts = 3600000UL / count * Kh;
+            if (watts >= NO_WATTS)
+                continue;
+            meter.decodePowermon(count | OOK_PACKET_INSTANT);
+            meter.Report(report);
+            s.compare(count, field(report, "CurrentPower"), (uint16_t)watts);
+        }
+    }
+    {
+        Sweep s("Blueline energy Wh");
+        for (unsigned long count = 0; count <= 0xFFFC; count += 4) {
+            word val16 = count | OOK_PACKET_TOTAL;
+            meter.decodePowermon(val16);
+            meter.Report(report);
+            s.compare(count, field(report, "TotalEnergy"), (uint16_t)(0.004f * val16 * Kh));
+        }
+    }
+}
+
+int main () {
+    acurite5n1();
+    acurite592tx();
+    blueline();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,324 @@
+/*
+* Linux receiver daemon.
+*
+* Runs the same Blueline, Acurite5n1 and Acurite592TX decoders as the sketch
+* on pulse data read from a file, FIFO or stdin (rtl_433 OOK pulse format,
+* see StreamPulseSource.h) and publishes to an MQTT broker under the same
+* topics as ookDecoder.ino.
+*
+*   g++ -O2 -pthread -Ihost -o ookdaemon host/ookdaemon.cpp
+*   mkfifo /run/ook.fifo
+*   ./ookdaemon -i /run/ook.fifo -b localhost &
+*   rtl_433 -w OOK:/run/ook.fifo
+*
+* Several receivers can feed one daemon, -i may be repeated:
+*
+*   ./ookdaemon -i /run/garage.fifo -i /run/attic.fifo -w 2000
+*
+* Every input gets its own ingest and decode threads.  Frames that pass their
+* check go through a lock-free queue to the aggregator, which folds copies of
+* the same transmission heard by several receivers into one (see
+* FrameAggregator.h) and feeds the survivors to the decoders whose readings
+* are published.
+*
+* With -n the reports go to an MQTT-SN gateway over UDP instead (see
+* MqttSn.h), at QoS -1 unless -q 0 is given:
+*
+*   ./ookdaemon -i /run/ook.fifo -n localhost:1884
+*
+* With -s the learned transmitter ID and rain counters are kept in a state
+* file (the EEPROM log of Checkpoint.h) and restored on the next start.
+*
+* Pulse ingestion, decoding, aggregation and publishing each run on their own
+* threads, linked by bounded queues.  Every thread sleeps in a blocking read
+* or a condition variable wait when there's nothing to do.
+*/
+
+#include <Arduino.h>
+
+#include <getopt.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <list>
+#include <string>
+#include <thread>
+
+#include "../OokReceiver.h"
+#include "../Checkpoint.h"
+#include "../MqttSn.h"
+#include "BoundedQueue.h"
+#include "FrameAggregator.h"
+#include "MpscQueue.h"
+#include "MqttClient.h"
+#include "PulseClassifier.h"
+#include "StreamPulseSource.h"
+#include "UdpSocket.h"
+
+#define VERSION        "v0.9 20151228"
+#define PULSE_BACKLOG  4096  // pulses between ingest and decode, per input
+#define FRAME_BACKLOG  4096  // frames between the decoders and the aggregator
+#define REPORT_BACKLOG 64    // messages between aggregator and publish
+#define SN_LINGER      20    // ms an MQTT-SN batch waits for more messages
+
+struct Message {
+    std::string topic;
+    std::string payload;
+};
+
+// a pulse and the signal strength of the package it belongs to
+struct RxPulse {
+    Pulse pulse;
+    byte sym;  // preamble symbol, classified in batches on the ingest side
+    int rssi;
+};
+
+struct Input {
+    int index;
+    const char* path;
+    BoundedQueue<RxPulse> pulses;
+    int rssi;  // of the package being decoded
+
+    Input (int i, const char* p) : index(i), path(p), pulses(PULSE_BACKLOG), rssi(0) {}
+};
+
+typedef BoundedQueue<Message>::Clock SteadyClock;
+
+static MpscQueue<ReceivedFrame, FRAME_BACKLOG> frameQueue;
+static std::atomic<int> activeInputs(0);
+static BoundedQueue<Message> publishQueue(REPORT_BACKLOG);
+static Checkpoint<ReceiverState> checkpoint;
+static bool persist;      // keep state across restarts
+static bool haveState;    // restored from the last run
+static ReceiverState restored;
+
+static void queueReport (const char* topic, const char* payload) {
+    publishQueue.push(Message{topic, payload});
+}
+
+static bool isFifo (FILE* in) {
+    struct stat st;
+    return fstat(fileno(in), &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+// read pulses until the input ends, a FIFO is reopened when its writer
+// goes away so the daemon outlives restarts of the radio side
+static void ingest (Input& input) {
+    bool useStdin = strcmp(input.path, "-") == 0;
+    for (;;) {
+        FILE* in = useStdin ? stdin : fopen(input.path, "r");
+        if (!in) {
+            perror(input.path);
+            break;
+        }
+
+        StreamPulseSource source(in);
+        PulseClassifier classify;
+        Pulse buf[PulseClassifier::BATCH];
+        byte sym[PulseClassifier::BATCH];
+        byte n;
+        while ((n = source.read(buf, PulseClassifier::BATCH)) > 0) {
+            // trace time starts over with every rtl_433 run, latency is
+            // measured from when the pulses got here
+            unsigned long arrived = micros();
+            classify(buf, sym, n);
+            for (byte i = 0; i < n; ++i) {
+                buf[i].time = arrived;
+                input.pulses.push(RxPulse{buf[i], sym[i], source.rssi});
+            }
+        }
+
+        bool reopen = !useStdin && isFifo(in);
+        if (!useStdin)
+            fclose(in);
+        if (!reopen)
+            break;
+    }
+    input.pulses.close();
+}
+
+static void queueFrame (void* context, const Frame& frame) {
+    Input* input = (Input*)context;
+    frameQueue.push(ReceivedFrame{frame, input->index, input->rssi, SteadyClock::now()});
+}
+
+// one per input, turns its pulses into checked raw frames
+static void decode (Input& input) {
+    OokReceiver receiver(13);
+    if (haveState)
+        receiver.setState(restored);
+    receiver.onFrame(queueFrame, &input);
+    RxPulse p;
+
+    while (input.pulses.pop(p)) {
+        input.rssi = p.rssi;
+        receiver.nextPulse(p.pulse, p.sym);
+    }
+    // input is gone, flush what's left
+    receiver.gap();
+    fprintf(stderr, "%s: %u frames recovered by voting\n", input.path,
+        receiver.blueline.recovered() + receiver.acurite5n1.recovered() + receiver.acurite592tx.recovered());
+
+    // the last one out closes the queue, the aggregator drains it and stops
+    if (--activeInputs == 0)
+        frameQueue.close();
+}
+
+// merge the frames of all inputs and publish the readings they make up
+static void aggregate (unsigned reportSecs, unsigned windowMs) {
+    OokReceiver readings(13);
+    if (haveState)
+        readings.setState(restored);
+    ReceiverState state;
+    SteadyClock::duration window = std::chrono::milliseconds(windowMs);
+    SteadyClock::duration interval = std::chrono::seconds(reportSecs);
+    FrameAggregator dedup(window);
+    char packet[REPORT_SIZE];
+    SteadyClock::time_point next = SteadyClock::now() + interval;
+    auto apply = [&readings] (const ReceivedFrame& r) { readings.apply(r.frame); };
+    ReceivedFrame r;
+
+    for (;;) {
+        bool done = frameQueue.isClosed();
+        while (frameQueue.pop(r))
+            dedup.add(r);
+        if (done)
+            break;
+
+        SteadyClock::time_point now = SteadyClock::now();
+        SteadyClock::time_point wake = dedup.flush(now, apply);
+        if (now >= next) {
+            queueReport("ookDecoder", "report");
+            readings.report(packet, queueReport);
+            if (persist) {
+                readings.getState(state);
+                checkpoint.save(state);
+            }
+            next += interval;
+        }
+        frameQueue.wait(wake < next ? wake : next);
+    }
+
+    dedup.drain(apply);
+    readings.report(packet, queueReport);
+    if (persist) {
+        readings.getState(state);
+        checkpoint.save(state);
+    }
+    fprintf(stderr, "%lu unique frames, %lu duplicates dropped\n", dedup.unique, dedup.duplicates);
+    publishQueue.close();
+}
+
+static void publish (MqttClient& mqtt) {
+    Message m;
+    while (publishQueue.pop(m)) {
+        // one retry covers a broker that dropped us since the last report
+        if (!mqtt.publish(m.topic.c_str(), m.payload.c_str()) &&
+            !mqtt.publish(m.topic.c_str(), m.payload.c_str()))
+            fprintf(stderr, "publish to %s failed\n", m.topic.c_str());
+    }
+    mqtt.disconnect();
+}
+
+// the same over MQTT-SN, what comes in together goes out in one datagram
+static void publishSn (MqttSnClient<UdpSocket>& sn) {
+    Message m;
+    for (;;) {
+        if (publishQueue.pop(m, SteadyClock::now() + std::chrono::milliseconds(SN_LINGER))) {
+            if (!sn.publish(m.topic.c_str(), m.payload.c_str()))
+                fprintf(stderr, "%s isn't a predefined MQTT-SN topic\n", m.topic.c_str());
+            continue;
+        }
+        sn.flush();
+        if (publishQueue.isClosed())
+            break;
+    }
+}
+
+static void usage (const char* name) {
+    fprintf(stderr, "usage: %s [-i input|-]... [-b broker] [-p port] [-c client-id] [-r report-secs] [-w dedup-ms] [-s state-file] [-n gateway[:port]] [-q qos]\n", name);
+}
+
+int main (int argc, char** argv) {
+    std::list<Input> inputs;
+    const char* broker = "localhost";
+    const char* clientId = "ookDaemon";
+    int port = 1883;
+    unsigned reportSecs = 30;
+    unsigned windowMs = 2000;
+    const char* statePath = 0;
+    std::string gateway;
+    int gatewayPort = MQTTSN_PORT;
+    int qos = -1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:b:p:c:r:w:s:n:q:")) != -1) {
+        switch (opt) {
+            case 'i': inputs.emplace_back(inputs.size(), optarg); break;
+            case 'b': broker = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'c': clientId = optarg; break;
+            case 'r': reportSecs = atoi(optarg); break;
+            case 'w': windowMs = atoi(optarg); break;
+            case 's': statePath = optarg; break;
+            case 'n': {
+                gateway = optarg;
+                size_t colon = gateway.find(':');
+                if (colon != std::string::npos) {
+                    gatewayPort = atoi(gateway.c_str() + colon + 1);
+                    gateway.erase(colon);
+                }
+                break;
+            }
+            case 'q': qos = atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (reportSecs == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (inputs.empty())
+        inputs.emplace_back(0, "-");
+
+    if (statePath) {
+        if (!EEPROM.open(statePath)) {
+            perror(statePath);
+            return 1;
+        }
+        persist = true;
+        haveState = checkpoint.restore(restored);
+    }
+
+    MqttClient mqtt(broker, port, clientId);
+    UdpSocket udp;
+    byte gatewayIp[4];
+    MqttSnClient<UdpSocket> sn(udp, gatewayIp, gatewayPort);
+    if (!gateway.empty()) {
+        if (!UdpSocket::resolve(gateway.c_str(), gatewayIp) || !udp.begin(0)) {
+            fprintf(stderr, "%s: can't reach the gateway\n", gateway.c_str());
+            return 1;
+        }
+        sn.setQos(qos);
+        if (qos >= 0)
+            sn.connect(clientId);
+    }
+    queueReport("ookDecoder", "online");
+    queueReport("ookDecoder", VERSION);
+
+    std::list<std::thread> threads;
+    activeInputs = inputs.size();
+    if (gateway.empty())
+        threads.emplace_back(publish, std::ref(mqtt));
+    else
+        threads.emplace_back(publishSn, std::ref(sn));
+    threads.emplace_back(aggregate, reportSecs, windowMs);
+    for (Input& input : inputs) {
+        threads.emplace_back(decode, std::ref(input));
+        threads.emplace_back(ingest, std::ref(input));
+    }
+
+    for (std::thread& t : threads)
+        t.join();
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+* Random frames against the Blueline CRC check and single bit correction.
+*
+*   g++ -O2 -Ihost -o ookfuzz host/ookfuzz.cpp
+*   ./ookfuzz [frames]
+*
+* Noise that gets through the sync looks like random 24 bit frames.  Those
+* are fed to the decoder 100 ms apart, about as often as noise can end up
+* looking like a frame.  About 2 in 256 pass the CRC by chance (the ID CRC
+* or the offset one).  Neither voting nor correction should add to that:
+* random copies are never close enough to each other to be voted on, and
+* nothing agrees with a correction of one.
+*
+* Then a real power packet is sent as three copies, each with a different
+* correctable bit flipped.  The first has nothing to agree with, the second
+* has to be corrected and the third taken as a repeat of it.
+*
+* Last, lone frames a minute after intact ones, each with a correctable bit
+* flipped.  A temperature that follows on from the one before has to be
+* corrected, energy and power readings have nothing to back them up and
+* must not be.
+*
+* Exits 1 if any check fails.
+*/
+
+#define LOG_LEVEL LOG_LEVEL_NONE
+
+#include <Arduino.h>
+
+#include <random>
+
+#include "../OokReceiver.h"
+
+#define FUZZ_FRAMES    1000000UL
+#define FUZZ_INTERVAL  100000UL  // us between random frames
+
+static byte crc8 (const byte* data, byte len) {
+    word crc = 0;
+    for (byte j = 0; j < len; ++j) {
+        crc ^= data[j] << 8;
+        for (byte i = 8; i > 0; --i) {
+            if (crc & 0x8000)
+                crc ^= 0x1070 << 3;
+            crc <<= 1;
+        }
+    }
+    return crc >> 8;
+}
+
+// a data frame as it goes on the air, the value offset by the ID
+static void dataFrame (word val16, byte frame[3]) {
+    byte plain[2] = { (byte)(val16 & 0xff), (byte)(val16 >> 8) };
+    word sent = val16 + DEFAULT_TX_ID;
+    frame[0] = sent & 0xff;
+    frame[1] = sent >> 8;
+    frame[2] = crc8(plain, 2);
+}
+
+static void powerFrame (word count, byte frame[3]) {
+    dataFrame((count & 0xfffc) | OOK_PACKET_INSTANT, frame);
+}
+
+// a frame with bit (0 the top of the first byte) flipped, through the decoder
+static bool send (Blueline& decoder, const byte frame[3], char bit) {
+    byte copy[3] = { frame[0], frame[1], frame[2] };
+    if (bit >= 0)
+        copy[bit >> 3] ^= 0x80 >> (bit & 7);
+    decoder.setData(copy, 3);
+    bool ok = decoder.decodeRxPacket();
+    decoder.resetDecoder();
+    return ok;
+}
+
+int main (int argc, char** argv) {
+    unsigned long frames = argc > 1 ? strtoul(argv[1], 0, 0) : FUZZ_FRAMES;
+    bool ok = true;
+
+    VirtualClock clock;
+    std::mt19937 noise(1);
+    Blueline random;
+    random.setClock(&clock);
+    unsigned long passed = 0, voted = 0, corrected = 0;
+    for (unsigned long n = 0; n < frames; ++n) {
+        unsigned long bits = noise();
+        byte frame[3] = { (byte)bits, (byte)(bits >> 8), (byte)(bits >> 16) };
+        clock.advance(FUZZ_INTERVAL);
+        random.setData(frame, 3);
+        // the decoder's counters are words, count here
+        word wasVoted = random.recovered(), wasCorrected = random.corrected();
+        if (random.decodeRxPacket())
+            ++passed;
+        voted += random.recovered() != wasVoted;
+        corrected += random.corrected() != wasCorrected;
+        random.resetDecoder();
+    }
+    printf("random: %lu frames, %lu passed (%.2f%%), %lu of them voted, %lu corrected (%.4f%%)\n",
+        frames, passed, 100.0 * passed / frames, voted, corrected, 100.0 * corrected / frames);
+    // the CRC alone lets 2/256 through, any more than a trace of votes or
+    // corrections on top of that means they take noise for copies
+    if (voted * 10000 > frames || corrected * 10000 > frames || passed * 256 > frames * 3) {
+        printf("FAIL: random frames get through\n");
+        ok = false;
+    }
+
+    Blueline packet;
+    packet.setClock(&clock);
+    byte frame[3];
+    powerFrame(3600, frame);
+    static const char flips[3] = { 3, 9, 20 };
+    byte taken = 0;
+    for (byte i = 0; i < 3; ++i) {
+        clock.advance(10000);
+        taken += send(packet, frame, flips[i]);
+    }
+    printf("repeats: %u of 3 copies taken, %u corrected\n", taken, packet.corrected());
+    if (taken != 2 || packet.corrected() != 1) {
+        printf("FAIL: confirmed corrections not taken\n");
+        ok = false;
+    }
+
+    Blueline lone;
+    lone.setClock(&clock);
+    byte temp[3], energy[3], power[3];
+    dataFrame(0x8000 | 0x10 | OOK_PACKET_TEMP, temp);
+    dataFrame(0x1000 | OOK_PACKET_TOTAL, energy);
+    powerFrame(3600, power);
+    send(lone, temp, -1);
+    send(lone, energy, -1);
+    send(lone, power, -1);
+    clock.advance(60000000UL);
+    dataFrame(0x8100 | 0x10 | OOK_PACKET_TEMP, temp);
+    dataFrame(0x1100 | OOK_PACKET_TOTAL, energy);
+    powerFrame(3000, power);
+    bool tempTaken = send(lone, temp, 9), energyTaken = send(lone, energy, 9),
+        powerTaken = send(lone, power, 3);
+    printf("lone: temperature %s, energy %s, power %s\n", tempTaken ? "corrected" : "dropped",
+        energyTaken ? "corrected" : "dropped", powerTaken ? "corrected" : "dropped");
+    if (!tempTaken || energyTaken || powerTaken) {
+        printf("FAIL: lone corrections\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
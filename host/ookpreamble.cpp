@@ -0,0 +1,126 @@
+/*
+* Compile the preambles in Preamble.h into the table of PreambleTable.h.
+*
+*   g++ -O2 -Ihost -o ookpreamble host/ookpreamble.cpp
+*   ./ookpreamble > PreambleTable.h
+*
+* A state of the combined recognizer is the preamble counter of every
+* protocol at once.  All states reachable from all counters at 0 are found
+* breadth first and numbered in that order, so state 0 is the idle state.
+* Buckets that every protocol treats the same are merged into one symbol
+* class to keep the table narrow.
+*/
+
+#include <Arduino.h>
+
+#include <map>
+#include <queue>
+#include <vector>
+
+#include "../Preamble.h"
+
+typedef std::vector<byte> Counts;
+
+static void printBytes (const char* indent, const std::vector<byte>& bytes) {
+    for (size_t i = 0; i < bytes.size(); ++i)
+        printf("%s0x%02X,%s", i % 16 ? " " : indent, bytes[i],
+            i % 16 == 15 || i + 1 == bytes.size() ? "\n" : "");
+}
+
+int main (void) {
+    // buckets with the same run/end membership in every protocol share a class
+    std::map<std::vector<bool>, byte> classOf;
+    std::vector<byte> bucketClass, classBucket;
+    for (byte b = 0; b < PREAMBLE_BUCKETS; ++b) {
+        std::vector<bool> key;
+        for (const PreambleSpec& p : preamble_specs) {
+            key.push_back(p.run & BUCKET(b));
+            key.push_back(p.end & BUCKET(b));
+        }
+        auto it = classOf.find(key);
+        if (it == classOf.end()) {
+            it = classOf.emplace(key, classBucket.size()).first;
+            classBucket.push_back(b);
+        }
+        bucketClass.push_back(it->second);
+    }
+    int symbols = classBucket.size() * 2;
+
+    std::map<Counts, int> index;
+    std::vector<Counts> states;
+    std::queue<Counts> todo;
+    Counts idle(PREAMBLE_PROTOCOLS, 0);
+    index[idle] = 0;
+    states.push_back(idle);
+    todo.push(idle);
+
+    std::vector<std::vector<int>> next;
+    std::vector<byte> ends(symbols, 0);
+    while (!todo.empty()) {
+        Counts c = todo.front();
+        todo.pop();
+        std::vector<int> row;
+        for (int sym = 0; sym < symbols; ++sym) {
+            byte bucket = classBucket[sym / 2], high = sym & 1;
+            Counts n(c.size());
+            for (size_t p = 0; p < c.size(); ++p) {
+                bool done;
+                n[p] = preambleCount(preamble_specs[p], c[p], bucket, high, done);
+                if (done)
+                    ends[sym] |= 1 << p;
+            }
+            auto it = index.find(n);
+            if (it == index.end()) {
+                it = index.emplace(n, states.size()).first;
+                states.push_back(n);
+                todo.push(n);
+            }
+            row.push_back(it->second);
+        }
+        next.push_back(row);
+    }
+
+    if (states.size() > 256) {
+        fprintf(stderr, "%zu states don't fit in a byte\n", states.size());
+        return 1;
+    }
+
+    // a protocol's preamble can only end from a state where it's complete
+    std::vector<byte> ready;
+    for (const Counts& c : states) {
+        byte mask = 0;
+        for (size_t p = 0; p < c.size(); ++p)
+            if (c[p] >= preamble_specs[p].count)
+                mask |= 1 << p;
+        ready.push_back(mask);
+    }
+
+    printf("/*\n* Generated by host/ookpreamble.cpp from Preamble.h, don't edit.\n*\n");
+    printf("* %zu states over %d symbols (%zu width classes by line level).\n*/\n\n",
+        states.size(), symbols, classBucket.size());
+    printf("#ifndef PREAMBLE_TABLE_H\n#define PREAMBLE_TABLE_H\n\n");
+    printf("#define PREAMBLE_STATES   %zu\n", states.size());
+    printf("#define PREAMBLE_SYMBOLS  %d\n\n", symbols);
+    printf("// width class of each bucket, symbol = class * 2 + level\n");
+    printf("const byte preamble_class[PREAMBLE_BUCKETS] PROGMEM = {\n");
+    printBytes("  ", bucketClass);
+    printf("};\n\n// protocols whose preamble ends with this symbol\n");
+    printf("const byte preamble_ends[PREAMBLE_SYMBOLS] PROGMEM = {\n");
+    printBytes("  ", ends);
+    printf("};\n\n// protocols whose preamble is complete in this state\n");
+    printf("const byte preamble_ready[PREAMBLE_STATES] PROGMEM = {\n");
+    printBytes("  ", ready);
+    printf("};\n\n// next state by state and symbol\n");
+    printf("const byte preamble_next[PREAMBLE_STATES][PREAMBLE_SYMBOLS] PROGMEM = {\n");
+    for (size_t i = 0; i < next.size(); ++i) {
+        printf("  {");
+        for (int n : next[i])
+            printf(" %3d,", n);
+        printf(" },  // %zu:", i);
+        for (byte c : states[i])
+            printf(" %d", c);
+        printf("\n");
+    }
+    printf("};\n\n#endif\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+* Replay recorded pulse data through the decoders at full speed.
+*
+*   g++ -O2 -Ihost -o ookreplay host/ookreplay.cpp
+*   ./ookreplay capture.ook
+*   ./ookreplay -r 60 day.ook
+*   ./ookreplay -r 60 -t 4294900000 day.ook
+*   rtl_433 -w OOK:- | ./ookreplay
+*
+* Reads from stdin when no file is given.  Decoded packets are printed as
+* they are found and the final report of every sensor at the end.  Time
+* follows the trace rather than the wall clock, with -r the reports are also
+* printed every report-secs of trace time, as the board would publish them.
+* -t starts the clock at a millis() other than 0, e.g. a minute before the
+* 32 bit rollover to see a board that has been up for 49 days.  If a frame
+* failed its check the pulses leading up to it are dumped as well, see
+* host/ookcapture.cpp.
+*/
+
+#include <Arduino.h>
+
+#include <unistd.h>
+
+#include "../OokReceiver.h"
+#include "PulseClassifier.h"
+#include "StreamPulseSource.h"
+
+static void printReport (const char* topic, const char* payload) {
+    printf("%s %s\n", topic, payload);
+}
+
+int main (int argc, char** argv) {
+    unsigned long reportSecs = 0;
+    unsigned long startMs = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "r:t:")) != -1) {
+        if (opt == 'r') {
+            reportSecs = strtoul(optarg, 0, 10);
+        } else if (opt == 't') {
+            startMs = strtoul(optarg, 0, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-r report-secs] [-t start-ms] [trace.ook]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE* in = stdin;
+    if (optind < argc && !(in = fopen(argv[optind], "r"))) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    StreamPulseSource source(in, startMs * 1000);
+    OokReceiver receiver(13);
+    VirtualClock clock(startMs);
+    ReportTimer reportTimer(&clock, reportSecs * 1000);
+    PulseClassifier classify;
+    PulseCapture capture;
+    char packet[REPORT_SIZE];
+    receiver.setClock(&clock);
+    receiver.onCapture(&capture);
+
+    while (!source.eof()) {
+        receiver.poll(source, classify);
+        if (reportSecs && reportTimer.due())
+            receiver.report(packet, printReport);
+    }
+    receiver.gap();
+
+    receiver.report(packet, printReport);
+    if (capture.isFrozen())
+        receiver.dumpCapture(packet, printReport);
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+* Stand-in MQTT-SN gateway for trying out the MQTT-SN publisher.
+*
+*   g++ -O2 -Ihost -o ooksngw host/ooksngw.cpp
+*   ./ooksngw -v
+*   ./ooksngw -a 0.0.0.0 -b localhost:1883
+*
+* Listens on UDP port MQTTSN_PORT (-p) of localhost (-a to take datagrams
+* from the board), maps predefined topic IDs back to names with the table in
+* MqttSn.h and prints every PUBLISH as "topic payload", the way ookreplay
+* prints reports.  With -b they are forwarded to an MQTT broker as well.
+* A CONNECT is answered with a CONNACK, any other message type is reported
+* and skipped.  With -v every datagram is summed up on stderr.
+*/
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <string>
+
+#include "../MqttSn.h"
+#include "MqttClient.h"
+#include "UdpSocket.h"
+
+static void usage (const char* name) {
+    fprintf(stderr, "usage: %s [-a listen-address] [-p port] [-b broker[:port]] [-v]\n", name);
+}
+
+int main (int argc, char** argv) {
+    const char* address = "127.0.0.1";
+    int port = MQTTSN_PORT;
+    std::string broker;
+    int brokerPort = 1883;
+    bool verbose = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "a:p:b:v")) != -1) {
+        switch (opt) {
+            case 'a': address = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'b': {
+                broker = optarg;
+                size_t colon = broker.find(':');
+                if (colon != std::string::npos) {
+                    brokerPort = atoi(broker.c_str() + colon + 1);
+                    broker.erase(colon);
+                }
+                break;
+            }
+            case 'v': verbose = true; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof local);
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    if (sock < 0 || inet_pton(AF_INET, address, &local.sin_addr) != 1 ||
+            bind(sock, (struct sockaddr*)&local, sizeof local) != 0) {
+        perror(address);
+        return 1;
+    }
+    MqttClient mqtt(broker.c_str(), brokerPort, "ooksngw");
+
+    byte buf[1500];
+    for (;;) {
+        struct sockaddr_in from;
+        socklen_t fromLen = sizeof from;
+        ssize_t n = recvfrom(sock, buf, sizeof buf, 0, (struct sockaddr*)&from, &fromLen);
+        if (n < 0) {
+            perror("recvfrom");
+            return 1;
+        }
+
+        int messages = 0;
+        for (ssize_t i = 0; i + 2 <= n; ++messages) {
+            // the length is one byte, or 0x01 and two more
+            size_t len = buf[i], head = 1;
+            if (len == 0x01 && i + 3 <= n) {
+                len = buf[i + 1] << 8 | buf[i + 2];
+                head = 3;
+            }
+            if (len < head + 1 || i + (ssize_t)len > n) {
+                fprintf(stderr, "bad length %zu at byte %zd\n", len, i);
+                break;
+            }
+            const byte* msg = buf + i + head;
+            size_t body = len - head;
+            i += len;
+
+            if (msg[0] == MQTTSN_CONNECT) {
+                static const byte connack[] = { 3, 0x05, 0x00 };
+                sendto(sock, connack, sizeof connack, 0, (struct sockaddr*)&from, fromLen);
+                continue;
+            }
+            if (msg[0] != MQTTSN_PUBLISH || body < 6) {
+                fprintf(stderr, "skipped message type 0x%02X\n", msg[0]);
+                continue;
+            }
+            word id = msg[2] << 8 | msg[3];
+            char topic[32];
+            if ((msg[1] & 0x03) != MQTTSN_PREDEF || !mqttsnTopicName(id, topic, sizeof topic)) {
+                fprintf(stderr, "unknown topic ID %u\n", id);
+                continue;
+            }
+            std::string payload((const char*)msg + 6, body - 6);
+            printf("%s %s\n", topic, payload.c_str());
+            if (!broker.empty() && !mqtt.publish(topic, payload.c_str()) &&
+                    !mqtt.publish(topic, payload.c_str()))
+                fprintf(stderr, "publish to %s failed\n", topic);
+        }
+        fflush(stdout);
+        if (verbose)
+            fprintf(stderr, "%zd bytes, %d messages from %s\n", n, messages, inet_ntoa(from.sin_addr));
+    }
+}
@@ -1,18 +1,43 @@
 #define VERSION "v0.9 20151228"
 
-#include <util/atomic.h>
-
 #include <SPI.h>
 #include <Ethernet.h>
+#include <EEPROM.h>
+
+//Uncomment to publish with MQTT-SN over UDP, to a gateway on port
+//MQTTSN_PORT of server, instead of MQTT over TCP.  Topics go out as the
+//predefined topic IDs of MqttSn.h.  There's no ookDecoder/cmd subscription
+//then, a capture dump is asked for with 'd' over serial.
+//#define USE_MQTTSN
+
+#ifdef USE_MQTTSN
+#include <EthernetUdp.h>
+#include "MqttSn.h"
+#else
 #include <PubSubClient.h>
+#endif
 
+//Serial log level (Log.h), the levels below it are compiled out.  At
+//LOG_LEVEL_DEBUG every published payload is echoed as well.
+//#define LOG_LEVEL LOG_LEVEL_DEBUG
 
-#include "DecodeOOK.h"
-#include "Blueline.h"
-#include "Acurite5n1.h"
-#include "Acurite592TX.h"
+#include "OokReceiver.h"
+#include "Checkpoint.h"
 
+//Uncomment to time pulses with the Timer1 input capture unit instead of the
+//pin-change interrupt.  The receiver must then be wired to ICP1 (pin 8).
+//#define USE_INPUT_CAPTURE
+
+//Uncomment to keep the last few pulse trains (CAPTURE_SIZE bytes of SRAM).
+//The record freezes when a frame fails its check and is dumped to
+//ookDecoder/capture on a 'd' over serial or "dump" sent to ookDecoder/cmd.
+//#define USE_CAPTURE
+
+#ifdef USE_INPUT_CAPTURE
+#define DPIN_OOK_RX  ICP_PIN
+#else
 #define DPIN_OOK_RX  2
+#endif
 #define DPIN_LED     13
 #define ARRAY_SIZE   200
 #define REPORT_TIME  30000
@@ -21,22 +46,41 @@ byte mac[]    = {  0xDE, 0xED, 0xBA, 0xFE, 0xFE, 0xED };
 byte server[] = { 192, 168, 0, 200 };
 byte ip[]     = { 192, 168, 0,  70};
 
+bool dumpRequested = false;
+
+#ifdef USE_MQTTSN
+EthernetUDP udp;
+MqttSnClient<EthernetUDP> client(udp, server);
+#else
 void callback(char* topic, byte* payload, unsigned int length) {
   // handle message arrived
+  if (length == 4 && memcmp(payload, "dump", 4) == 0)
+    dumpRequested = true;
 }
 
 EthernetClient ethClient;
 PubSubClient client(server, 1883, callback, ethClient);
+#endif
 
-Blueline blueline;
-Acurite5n1 acurite5n1;
-Acurite592TX acurite592tx;
+OokReceiver receiver(DPIN_LED);
+ReportTimer reportTimer(&systemClock, REPORT_TIME);
+Checkpoint<ReceiverState> checkpoint;
+ReceiverState state;
 
-volatile word pulse;  //pulse duration
+#ifdef USE_CAPTURE
+PulseCapture capture;
+#endif
 
-long previousMillis = 0;
+char packet[REPORT_SIZE];
 
-char packet[100];
+#ifdef USE_INPUT_CAPTURE
+InputCaptureSource pulses;
+
+ISR(TIMER1_CAPT_vect) {
+  pulses.capture();
+}
+#else
+PinChangeSource pulses(DPIN_OOK_RX);
 
 #if DPIN_OOK_RX >= 14
 #define VECT PCINT1_vect
@@ -47,36 +91,27 @@ char packet[100];
 #endif
 
 ISR(VECT) {
-  PinChange();
+  pulses.change();
 }
-
-static void setupPinChangeInterrupt ()
-{
-  pinMode(DPIN_OOK_RX, INPUT);
-#if DPIN_OOK_RX >= 14
-  bitSet(PCMSK1, DPIN_OOK_RX - 14);
-  bitSet(PCICR, PCIE1);
-#elif DPIN_OOK_RX >= 8
-  bitSet(PCMSK0, DPIN_OOK_RX - 8);
-  bitSet(PCICR, PCIE0);
-#else
-  PCMSK2 = bit(DPIN_OOK_RX);
-  bitSet(PCICR, PCIE2);
 #endif
+
+void publishReport (const char* topic, const char* payload) {
+    client.publish(topic, payload);
+    LOG_DEBUG(payload);
 }
 
-void PinChange(void) {
-    static word last;
-    // determine the pulse length in microseconds, for either polarity
-    pulse = micros() - last;
-    last += pulse;
+void reportAll () {
+    client.publish("ookDecoder","report");
+    receiver.report(packet, publishReport);
+    sprintf(packet, "Dropped=%u", logDropped());
+    publishReport("ookDecoder/log", packet);
 }
 
 void reportSerial (const char* s, class DecodeOOK& decoder) {
     byte pos;
     const byte* data = decoder.getData(pos);
     
-    Serial.print("["); Serial.print(millis() / 1000); Serial.print("] "); 
+    Serial.print("["); Serial.print(systemClock.millis() / 1000); Serial.print("] "); 
     for (byte i = 0; i < pos; ++i) {
       Serial.print(data[i] >> 4, HEX);
       Serial.print(data[i] & 0x0F, HEX);
@@ -94,85 +129,71 @@ void setup () {
     Serial.begin(38400);
     pinMode(DPIN_LED,OUTPUT);
     
-    setupPinChangeInterrupt();
+    if (checkpoint.restore(state))
+      receiver.setState(state);
+#ifdef USE_CAPTURE
+    receiver.onCapture(&capture);
+#endif
+    pulses.begin();
     
     Ethernet.begin(mac, ip);
+#ifdef USE_MQTTSN
+    udp.begin(MQTTSN_PORT);
+    client.publish("ookDecoder", "online");
+    client.publish("ookDecoder", VERSION);
+    client.flush();
+    LOG_INFO(F("ookDecoder started"));
+    LOG_INFO(F(VERSION));
+#else
     if (client.connect("arduinoClient")) {
       client.publish("ookDecoder", "online");
       client.publish("ookDecoder", VERSION);
-      Serial.println("ookDecoder started");
-      Serial.println(VERSION);
+      client.subscribe("ookDecoder/cmd");
+      LOG_INFO(F("ookDecoder started"));
+      LOG_INFO(F(VERSION));
     }
+#endif
 }
 
 void loop () {
 
-    //may have issues with rollover
-    unsigned long currentMillis = millis();
-    if(currentMillis - previousMillis > REPORT_TIME) {
-      previousMillis = currentMillis;  
+    if (reportTimer.due()) {
+#ifdef USE_MQTTSN
+      reportAll();
+      client.flush();
+#else
       if (client.connect("arduinoClient")) {
-        Serial.println("connected to arduinoClient");
-        client.publish("ookDecoder","report");
-        
-        blueline.MQTTreport(packet);
-        if (strlen(packet) > 0) {
-          client.publish("blueline",packet);
-          Serial.println(packet);
-        }
+        LOG_INFO(F("connected to arduinoClient"));
+        client.subscribe("ookDecoder/cmd");
         
-        acurite5n1.MQTTreport(packet);
-        if (strlen(packet) > 0) {
-          client.publish("acurite5n1",packet);
-          Serial.println(packet);
-        }
-        
-        acurite592tx.MQTTreport(packet);
-        if (strlen(packet) > 0) {
-          client.publish("acurite592tx",packet);
-          Serial.println(packet);
-        }
+        reportAll();
       } else {
-        Serial.println("connection failed");
+        LOG_WARN(F("connection failed"));
       }
+#endif
+      
+      receiver.getState(state);
+      checkpoint.save(state);
     }
 
-    static int i = 0;
-    word p;
-    
-    ATOMIC_BLOCK(ATOMIC_FORCEON)
-    {
-      p = pulse;
-      pulse = 0;
+#ifdef USE_MQTTSN
+    if (Serial.available() && Serial.read() == 'd')
+      dumpRequested = true;
+    if (dumpRequested) {
+      dumpRequested = false;
+      receiver.dumpCapture(packet, publishReport);
+      client.flush();
     }
-    
-    if (p>150 && p<2000) {
-      if (blueline.nextPulse(p)) {
-        //turn on led
-        digitalWrite(DPIN_LED, HIGH);
-        //reportSerial("Blueline", blueline);
-        blueline.decodeRxPacket();
-        //blueline.PrintRaw();
-        blueline.resetDecoder();
-        digitalWrite(DPIN_LED,LOW);
-      }
-      if (acurite5n1.nextPulse(p)) {
-        //turn on led
-        digitalWrite(DPIN_LED, HIGH);
-        //reportSerial("Acurite5n1", acurite5n1);
-        acurite5n1.DecodePacket();
-        //acurite5n1.PrintRaw();
-        acurite5n1.resetDecoder();
-        digitalWrite(DPIN_LED,LOW);
-      }
-      if (acurite592tx.nextPulse(p)) {
-        //turn on led
-        digitalWrite(DPIN_LED, HIGH);
-        //reportSerial("Acurite592TX", acurite592tx);
-        acurite592tx.DecodePacket();
-        //acurite592tx.PrintRaw();
-        acurite592tx.resetDecoder();
-        digitalWrite(DPIN_LED,LOW);
-      }
+#else
+    client.loop();
+    if (Serial.available() && Serial.read() == 'd')
+      dumpRequested = true;
+    if (dumpRequested) {
+      dumpRequested = false;
+      receiver.dumpCapture(packet, publishReport);
     }
-}
+#endif
+
+    receiver.poll(pulses);
+    logDrain(Serial);
+}